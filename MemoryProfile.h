@@ -0,0 +1,174 @@
+#ifndef TODO_MEMORY_PROFILE_H
+#define TODO_MEMORY_PROFILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace todo {
+
+// Opt-in memory accounting. When built with -DTODO_MEMORY_PROFILE, the
+// global allocator at the end of this header tags every block with the
+// subsystem active at allocation time. MemoryScope switches the
+// active subsystem and MemoryOperation counts allocations per API call.
+// Without the flag both are empty.
+enum MemoryTag { MemOther, MemTasks, MemDependencies, MemUndo, MemPriorityQueue, MemIndexes, MemQueries, MemArchive, MemTrace, MemTagCount };
+
+#ifdef TODO_MEMORY_PROFILE
+struct MemoryStats {
+    size_t currentBytes;
+    size_t peakBytes;
+    size_t allocations;
+    size_t liveAllocations;
+};
+
+struct OperationStats {
+    const char* name;
+    size_t calls;
+    size_t allocations;
+    size_t bytes;
+    size_t peakBytes;
+};
+
+// Counters are plain statics without locking, so profiling assumes a single
+// thread; they must be usable before any static constructor runs.
+struct MemoryProfile {
+    inline static MemoryStats tags[MemTagCount];
+    inline static MemoryStats total;
+    inline static MemoryTag currentTag = MemOther;
+    inline static size_t totalBytesAllocated;
+    inline static OperationStats operations[64];
+    inline static size_t operationCount;
+    inline static int operationDepth;
+    inline static size_t operationPeakBytes;
+    inline static bool allocatorInstalled;
+
+    static void recordAllocation(MemoryTag tag, size_t size) {
+        for (MemoryStats* stats : {&tags[tag], &total}) {
+            stats->currentBytes += size;
+            stats->peakBytes = std::max(stats->peakBytes, stats->currentBytes);
+            stats->allocations++;
+            stats->liveAllocations++;
+        }
+        totalBytesAllocated += size;
+        if (operationDepth > 0) operationPeakBytes = std::max(operationPeakBytes, total.currentBytes);
+    }
+
+    static void recordFree(MemoryTag tag, size_t size) {
+        for (MemoryStats* stats : {&tags[tag], &total}) {
+            stats->currentBytes -= size;
+            stats->liveAllocations--;
+        }
+    }
+
+    static OperationStats* operation(const char* name) {
+        for (size_t i = 0; i < operationCount; ++i) {
+            if (strcmp(operations[i].name, name) == 0) return &operations[i];
+        }
+        if (operationCount == sizeof(operations) / sizeof(operations[0])) return nullptr;
+        operations[operationCount] = OperationStats{name, 0, 0, 0, 0};
+        return &operations[operationCount++];
+    }
+};
+
+class MemoryScope {
+private:
+    MemoryTag previous;
+
+public:
+    explicit MemoryScope(MemoryTag tag) : previous(MemoryProfile::currentTag) { MemoryProfile::currentTag = tag; }
+    ~MemoryScope() { MemoryProfile::currentTag = previous; }
+};
+
+// Attributes the allocations made during one outermost API call to it,
+// along with how far the footprint rose above its level at the start.
+class MemoryOperation {
+private:
+    const char* name;
+    MemoryScope scope;
+    size_t allocationsBefore;
+    size_t bytesBefore;
+    size_t footprintBefore;
+
+public:
+    MemoryOperation(const char* operationName, MemoryTag tag = MemTasks)
+        : name(operationName), scope(tag), allocationsBefore(MemoryProfile::total.allocations),
+          bytesBefore(MemoryProfile::totalBytesAllocated), footprintBefore(MemoryProfile::total.currentBytes) {
+        if (MemoryProfile::operationDepth++ == 0) MemoryProfile::operationPeakBytes = footprintBefore;
+    }
+
+    ~MemoryOperation() {
+        if (--MemoryProfile::operationDepth > 0) return;
+        OperationStats* stats = MemoryProfile::operation(name);
+        if (!stats) return;
+        stats->calls++;
+        stats->allocations += MemoryProfile::total.allocations - allocationsBefore;
+        stats->bytes += MemoryProfile::totalBytesAllocated - bytesBefore;
+        stats->peakBytes = std::max(stats->peakBytes, MemoryProfile::operationPeakBytes - footprintBefore);
+    }
+};
+#else
+struct MemoryScope {
+    explicit MemoryScope(MemoryTag) {}
+};
+
+struct MemoryOperation {
+    MemoryOperation(const char*, MemoryTag = MemTasks) {}
+};
+#endif
+
+}  // namespace todo
+
+#endif
+
+// Replacement global allocator for profiling builds. Replacing operator new
+// is a whole-program definition, so exactly one translation unit must define
+// TODO_MEMORY_PROFILE_IMPLEMENTATION before including this header: none and
+// every counter stays at zero (MemoryProfile::allocatorInstalled is false),
+// more than one and the program fails to link.
+#if defined(TODO_MEMORY_PROFILE) && defined(TODO_MEMORY_PROFILE_IMPLEMENTATION) && !defined(TODO_MEMORY_PROFILE_ALLOCATOR)
+#define TODO_MEMORY_PROFILE_ALLOCATOR
+
+#include <cstdlib>
+#include <new>
+
+// Every block carries its size and the subsystem tag that was active when
+// it was allocated. The operators stay out of line: once inlined, GCC sees
+// the header lookup as indexing before the caller's object and reports a
+// false -Warray-bounds.
+#if defined(__GNUC__)
+#define TODO_ALLOCATOR_NOINLINE __attribute__((noinline))
+#else
+#define TODO_ALLOCATOR_NOINLINE
+#endif
+
+struct alignas(alignof(std::max_align_t)) TodoAllocationHeader {
+    std::size_t size;
+    todo::MemoryTag tag;
+};
+
+TODO_ALLOCATOR_NOINLINE void* operator new(std::size_t size) {
+    void* block = malloc(sizeof(TodoAllocationHeader) + size);
+    if (!block) throw std::bad_alloc();
+    TodoAllocationHeader* header = static_cast<TodoAllocationHeader*>(block);
+    header->size = size;
+    header->tag = todo::MemoryProfile::currentTag;
+    todo::MemoryProfile::allocatorInstalled = true;
+    todo::MemoryProfile::recordAllocation(header->tag, size);
+    return header + 1;
+}
+
+TODO_ALLOCATOR_NOINLINE void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    TodoAllocationHeader* header = static_cast<TodoAllocationHeader*>(pointer) - 1;
+    todo::MemoryProfile::recordFree(header->tag, header->size);
+    free(header);
+}
+
+TODO_ALLOCATOR_NOINLINE void* operator new[](std::size_t size) { return operator new(size); }
+TODO_ALLOCATOR_NOINLINE void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+TODO_ALLOCATOR_NOINLINE void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+TODO_ALLOCATOR_NOINLINE void operator delete[](void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+#undef TODO_ALLOCATOR_NOINLINE
+#endif
@@ -0,0 +1,27 @@
+#ifndef TODO_TASK_H
+#define TODO_TASK_H
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace todo {
+
+class Task {
+public:
+    std::string name;
+    std::string status;
+    int priority;
+    std::string dueDate;
+    std::vector<std::string> categories;
+    std::string reminderDate;
+    std::unordered_set<int> dependencies;
+    std::string notes;
+
+    Task(const std::string& taskName, const std::string& taskStatus = "Incomplete")
+        : name(taskName), status(taskStatus), priority(0) {}
+};
+
+}  // namespace todo
+
+#endif
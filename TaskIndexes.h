@@ -0,0 +1,419 @@
+#ifndef TODO_TASK_INDEXES_H
+#define TODO_TASK_INDEXES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace todo {
+
+// Compressed bitmap of task slots in the style of Roaring bitmaps. Slots are
+// split into 64K chunks by their high 16 bits; each chunk is stored as a
+// sorted array while sparse and as a 1024-word bitset once it holds more
+// than 4096 slots. The word loops are kept branch-free so the compiler can
+// vectorise them.
+class TaskBitmap {
+private:
+    static constexpr size_t arrayLimit = 4096;
+    static constexpr size_t bitsetWords = 1024;
+
+    struct Container {
+        std::vector<uint16_t> values;
+        std::vector<uint64_t> words;
+        size_t cardinality = 0;
+
+        bool isBitset() const { return !words.empty(); }
+
+        bool contains(uint16_t low) const {
+            if (isBitset()) return (words[low >> 6] >> (low & 63)) & 1;
+            return std::binary_search(values.begin(), values.end(), low);
+        }
+
+        void toBitset() {
+            words.assign(bitsetWords, 0);
+            for (uint16_t low : values) words[low >> 6] |= uint64_t(1) << (low & 63);
+            values.clear();
+            values.shrink_to_fit();
+        }
+
+        void toArray() {
+            values.clear();
+            values.reserve(cardinality);
+            for (size_t w = 0; w < bitsetWords; ++w) {
+                for (uint64_t word = words[w]; word; word &= word - 1) {
+                    values.push_back(uint16_t(w * 64 + countTrailingZeros(word)));
+                }
+            }
+            words.clear();
+            words.shrink_to_fit();
+        }
+
+        // Recounts a bitset after a word-wise operation and drops back to
+        // an array when it becomes sparse.
+        void normalise() {
+            if (!isBitset()) {
+                cardinality = values.size();
+                return;
+            }
+            cardinality = 0;
+            for (size_t w = 0; w < bitsetWords; ++w) cardinality += popCount(words[w]);
+            if (cardinality <= arrayLimit) toArray();
+        }
+
+        bool add(uint16_t low) {
+            if (isBitset()) {
+                uint64_t& word = words[low >> 6];
+                uint64_t bit = uint64_t(1) << (low & 63);
+                if (word & bit) return false;
+                word |= bit;
+                cardinality++;
+                return true;
+            }
+            auto position = std::lower_bound(values.begin(), values.end(), low);
+            if (position != values.end() && *position == low) return false;
+            values.insert(position, low);
+            cardinality++;
+            if (cardinality > arrayLimit) toBitset();
+            return true;
+        }
+
+        bool remove(uint16_t low) {
+            if (isBitset()) {
+                uint64_t& word = words[low >> 6];
+                uint64_t bit = uint64_t(1) << (low & 63);
+                if (!(word & bit)) return false;
+                word &= ~bit;
+                cardinality--;
+                if (cardinality <= arrayLimit) toArray();
+                return true;
+            }
+            auto position = std::lower_bound(values.begin(), values.end(), low);
+            if (position == values.end() || *position != low) return false;
+            values.erase(position);
+            cardinality--;
+            return true;
+        }
+    };
+
+    enum Operation { And, Or, AndNot };
+
+    std::vector<uint16_t> keys;
+    std::vector<Container> containers;
+
+    static size_t popCount(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(word);
+#else
+        size_t count = 0;
+        for (; word; word &= word - 1) count++;
+        return count;
+#endif
+    }
+
+    static int countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(word);
+#else
+        int count = 0;
+        for (; !(word & 1); word >>= 1) count++;
+        return count;
+#endif
+    }
+
+    static Container combine(const Container& a, const Container& b, Operation op) {
+        Container result;
+        if (!a.isBitset() && b.isBitset() && op != Or) {
+            for (uint16_t low : a.values) {
+                if (b.contains(low) == (op == And)) result.values.push_back(low);
+            }
+        } else if (a.isBitset() && !b.isBitset() && op == And) {
+            for (uint16_t low : b.values) {
+                if (a.contains(low)) result.values.push_back(low);
+            }
+        } else if (a.isBitset() || b.isBitset()) {
+            Container left = a;
+            Container right = b;
+            if (!left.isBitset()) left.toBitset();
+            if (!right.isBitset()) right.toBitset();
+            result.words.resize(bitsetWords);
+            uint64_t* out = result.words.data();
+            const uint64_t* x = left.words.data();
+            const uint64_t* y = right.words.data();
+            switch (op) {
+                case And:
+                    for (size_t w = 0; w < bitsetWords; ++w) out[w] = x[w] & y[w];
+                    break;
+                case Or:
+                    for (size_t w = 0; w < bitsetWords; ++w) out[w] = x[w] | y[w];
+                    break;
+                case AndNot:
+                    for (size_t w = 0; w < bitsetWords; ++w) out[w] = x[w] & ~y[w];
+                    break;
+            }
+        } else {
+            switch (op) {
+                case And:
+                    std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(result.values));
+                    break;
+                case Or:
+                    std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(result.values));
+                    if (result.values.size() > arrayLimit) {
+                        result.cardinality = result.values.size();
+                        result.toBitset();
+                    }
+                    break;
+                case AndNot:
+                    std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), std::back_inserter(result.values));
+                    break;
+            }
+        }
+        result.normalise();
+        return result;
+    }
+
+    static TaskBitmap combine(const TaskBitmap& a, const TaskBitmap& b, Operation op) {
+        TaskBitmap result;
+        size_t i = 0, j = 0;
+        while (i < a.keys.size() || j < b.keys.size()) {
+            bool fromA = j == b.keys.size() || (i < a.keys.size() && a.keys[i] < b.keys[j]);
+            bool fromB = i == a.keys.size() || (j < b.keys.size() && b.keys[j] < a.keys[i]);
+            if (fromA) {
+                if (op != And) result.append(a.keys[i], a.containers[i]);
+                i++;
+            } else if (fromB) {
+                if (op == Or) result.append(b.keys[j], b.containers[j]);
+                j++;
+            } else {
+                result.append(a.keys[i], combine(a.containers[i], b.containers[j], op));
+                i++;
+                j++;
+            }
+        }
+        return result;
+    }
+
+    void append(uint16_t key, const Container& container) {
+        if (container.cardinality == 0) return;
+        keys.push_back(key);
+        containers.push_back(container);
+    }
+
+public:
+    bool add(uint32_t slot) {
+        uint16_t key = slot >> 16;
+        auto position = std::lower_bound(keys.begin(), keys.end(), key);
+        size_t index = position - keys.begin();
+        if (position == keys.end() || *position != key) {
+            keys.insert(position, key);
+            containers.insert(containers.begin() + index, Container());
+        }
+        return containers[index].add(uint16_t(slot));
+    }
+
+    bool remove(uint32_t slot) {
+        uint16_t key = slot >> 16;
+        auto position = std::lower_bound(keys.begin(), keys.end(), key);
+        if (position == keys.end() || *position != key) return false;
+        size_t index = position - keys.begin();
+        if (!containers[index].remove(uint16_t(slot))) return false;
+        if (containers[index].cardinality == 0) {
+            keys.erase(position);
+            containers.erase(containers.begin() + index);
+        }
+        return true;
+    }
+
+    bool contains(uint32_t slot) const {
+        auto position = std::lower_bound(keys.begin(), keys.end(), uint16_t(slot >> 16));
+        return position != keys.end() && *position == uint16_t(slot >> 16) &&
+               containers[position - keys.begin()].contains(uint16_t(slot));
+    }
+
+    size_t cardinality() const {
+        size_t total = 0;
+        for (const Container& container : containers) total += container.cardinality;
+        return total;
+    }
+
+    bool empty() const { return keys.empty(); }
+
+    void clear() {
+        keys.clear();
+        containers.clear();
+    }
+
+    TaskBitmap operator&(const TaskBitmap& other) const { return combine(*this, other, And); }
+    TaskBitmap operator|(const TaskBitmap& other) const { return combine(*this, other, Or); }
+    TaskBitmap andNot(const TaskBitmap& other) const { return combine(*this, other, AndNot); }
+
+    // Visits slots in ascending order until the visitor returns false.
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uint32_t high = uint32_t(keys[i]) << 16;
+            const Container& container = containers[i];
+            if (!container.isBitset()) {
+                for (uint16_t low : container.values) {
+                    if (!visit(int(high | low))) return;
+                }
+                continue;
+            }
+            for (size_t w = 0; w < bitsetWords; ++w) {
+                for (uint64_t word = container.words[w]; word; word &= word - 1) {
+                    if (!visit(int(high | (w * 64 + countTrailingZeros(word))))) return;
+                }
+            }
+        }
+    }
+};
+
+// Order-statistic tree (a treap with subtree sizes) over (key, task index)
+// pairs. Rank, select and pagination all run in O(log n + page). Nodes live
+// in a pooled vector and are linked by index.
+template <typename Key>
+class OrderStatisticTree {
+private:
+    struct Node {
+        Key key;
+        int taskIndex;
+        uint32_t weight;
+        int size;
+        int left;
+        int right;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    int root;
+    uint32_t seed;
+
+    int sizeOf(int node) const { return node == -1 ? 0 : nodes[node].size; }
+
+    void update(int node) { nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right); }
+
+    bool less(const Key& key, int taskIndex, int node) const {
+        return key < nodes[node].key || (!(nodes[node].key < key) && taskIndex < nodes[node].taskIndex);
+    }
+
+    // Splits a subtree into entries ordered before (key, taskIndex) and the rest.
+    void split(int node, const Key& key, int taskIndex, int& left, int& right) {
+        if (node == -1) {
+            left = right = -1;
+            return;
+        }
+        if (nodes[node].key < key || (!(key < nodes[node].key) && nodes[node].taskIndex < taskIndex)) {
+            split(nodes[node].right, key, taskIndex, nodes[node].right, right);
+            left = node;
+        } else {
+            split(nodes[node].left, key, taskIndex, left, nodes[node].left);
+            right = node;
+        }
+        update(node);
+    }
+
+    int merge(int left, int right) {
+        if (left == -1) return right;
+        if (right == -1) return left;
+        if (nodes[left].weight > nodes[right].weight) {
+            nodes[left].right = merge(nodes[left].right, right);
+            update(left);
+            return left;
+        }
+        nodes[right].left = merge(left, nodes[right].left);
+        update(right);
+        return right;
+    }
+
+    void collect(int node, int offset, int from, int to, std::vector<int>& out) const {
+        if (node == -1 || from >= to) return;
+        int leftSize = sizeOf(nodes[node].left);
+        int position = offset + leftSize;
+        if (from < position) collect(nodes[node].left, offset, from, to, out);
+        if (from <= position && position < to) out.push_back(nodes[node].taskIndex);
+        if (to > position + 1) collect(nodes[node].right, position + 1, from, to, out);
+    }
+
+public:
+    OrderStatisticTree() : root(-1), seed(2463534242u) {}
+
+    int size() const { return sizeOf(root); }
+
+    void clear() {
+        nodes.clear();
+        freeNodes.clear();
+        root = -1;
+    }
+
+    void insert(const Key& key, int taskIndex) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int node;
+        if (freeNodes.empty()) {
+            node = nodes.size();
+            nodes.push_back(Node{key, taskIndex, seed, 1, -1, -1});
+        } else {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[node] = Node{key, taskIndex, seed, 1, -1, -1};
+        }
+        int left, right;
+        split(root, key, taskIndex, left, right);
+        root = merge(merge(left, node), right);
+    }
+
+    bool erase(const Key& key, int taskIndex) {
+        int left, middle, right;
+        split(root, key, taskIndex, left, right);
+        split(right, key, taskIndex + 1, middle, right);
+        bool found = middle != -1;
+        if (found) freeNodes.push_back(middle);
+        root = merge(left, right);
+        return found;
+    }
+
+    // Number of entries ordered before (key, taskIndex).
+    int rank(const Key& key, int taskIndex) const {
+        int result = 0;
+        for (int node = root; node != -1;) {
+            if (less(key, taskIndex, node)) {
+                node = nodes[node].left;
+            } else {
+                result += sizeOf(nodes[node].left) + (nodes[node].key < key || nodes[node].taskIndex < taskIndex);
+                node = nodes[node].right;
+            }
+        }
+        return result;
+    }
+
+    // Task index at the given rank, or -1 if out of range.
+    int select(int position) const {
+        for (int node = root; node != -1;) {
+            int leftSize = sizeOf(nodes[node].left);
+            if (position < leftSize) {
+                node = nodes[node].left;
+            } else if (position == leftSize) {
+                return nodes[node].taskIndex;
+            } else {
+                position -= leftSize + 1;
+                node = nodes[node].right;
+            }
+        }
+        return -1;
+    }
+
+    // Task indices ranked [from, from + count), clamped to the tree. The end
+    // is computed in 64 bits so a huge count cannot overflow.
+    std::vector<int> page(int from, int count) const {
+        std::vector<int> result;
+        int to = int(std::min<long long>((long long)from + count, size()));
+        result.reserve(std::max(0, to - from));
+        collect(root, 0, from, to, result);
+        return result;
+    }
+};
+
+}  // namespace todo
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef TODO_TASK_QUERY_H
+#define TODO_TASK_QUERY_H
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Task.h"
+
+namespace todo {
+
+// Compiled form of a task query such as
+//   status:open prio>=3 cat:backend,frontend -cat:ops due<2026-11-01 sort:due,-prio limit:50
+// Repeated "cat:" terms must all match, comma-separated categories inside one
+// term match any of them, and words without a field are matched against the
+// task name and notes.
+class TaskQuery {
+public:
+    enum StatusFilter { AnyStatus, OpenOnly, CompleteOnly };
+    enum SortKey { SortByDue, SortByPriority, SortByName, SortByStatus };
+    enum Strategy { EmptyResult, FullScan, BitmapScan, SortedViewScan };
+
+    StatusFilter status;
+    int minPriority;
+    int maxPriority;
+    std::string dueFrom;
+    bool dueFromExclusive;
+    std::string dueTo;
+    bool dueToExclusive;
+    bool requireDueDate;
+    bool requireNoDueDate;
+    std::vector<std::vector<std::string> > categoryGroups;
+    std::vector<std::string> excludedCategories;
+    std::vector<std::string> keywords;
+    std::vector<std::pair<SortKey, bool> > sortKeys;
+    size_t limit;
+    std::string error;
+
+    TaskQuery()
+        : status(AnyStatus), minPriority(INT_MIN), maxPriority(INT_MAX), dueFromExclusive(false),
+          dueToExclusive(false), requireDueDate(false), requireNoDueDate(false), limit(0) {}
+
+    static TaskQuery parse(const std::string& text) {
+        TaskQuery query;
+        size_t end = 0;
+        while (query.error.empty()) {
+            size_t start = text.find_first_not_of(" \t\r\n", end);
+            if (start == std::string::npos) break;
+            end = text.find_first_of(" \t\r\n", start);
+            query.parseTerm(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        }
+        return query;
+    }
+
+    bool matches(const Task& task) const {
+        if (status != AnyStatus && (task.status == "Complete") != (status == CompleteOnly)) return false;
+        for (const std::vector<std::string>& group : categoryGroups) {
+            bool found = false;
+            for (const std::string& category : group) {
+                if (std::find(task.categories.begin(), task.categories.end(), category) != task.categories.end()) {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) return false;
+        }
+        for (const std::string& category : excludedCategories) {
+            if (std::find(task.categories.begin(), task.categories.end(), category) != task.categories.end()) return false;
+        }
+        return matchesFields(task);
+    }
+
+    // The part of the filter that bitmap indexes cannot answer.
+    bool matchesFields(const Task& task) const {
+        if (task.priority < minPriority || task.priority > maxPriority) return false;
+        if (requireNoDueDate && !task.dueDate.empty()) return false;
+        if (requireDueDate) {
+            if (task.dueDate.empty()) return false;
+            if (!dueFrom.empty() && (task.dueDate < dueFrom || (dueFromExclusive && task.dueDate == dueFrom))) return false;
+            if (!dueTo.empty() && (task.dueDate > dueTo || (dueToExclusive && task.dueDate == dueTo))) return false;
+        }
+        for (const std::string& keyword : keywords) {
+            if (task.name.find(keyword) == std::string::npos && task.notes.find(keyword) == std::string::npos) return false;
+        }
+        return true;
+    }
+
+    // Compares two tasks on one sort key, with the key's direction applied.
+    // Tasks without a due date always sort after dated ones.
+    int compareOn(size_t keyIndex, const Task& a, const Task& b) const {
+        int order = 0;
+        switch (sortKeys[keyIndex].first) {
+            case SortByDue:
+                if (a.dueDate.empty() != b.dueDate.empty()) return a.dueDate.empty() ? 1 : -1;
+                order = a.dueDate.compare(b.dueDate);
+                break;
+            case SortByPriority:
+                order = (a.priority > b.priority) - (a.priority < b.priority);
+                break;
+            case SortByName:
+                order = a.name.compare(b.name);
+                break;
+            case SortByStatus:
+                order = a.status.compare(b.status);
+                break;
+        }
+        return sortKeys[keyIndex].second ? -order : order;
+    }
+
+    // Orders two tasks by the sort keys, falling back to list position.
+    bool before(const Task& a, int aIndex, const Task& b, int bIndex) const {
+        for (size_t i = 0; i < sortKeys.size(); ++i) {
+            int order = compareOn(i, a, b);
+            if (order != 0) return order < 0;
+        }
+        return aIndex < bIndex;
+    }
+
+    // Name of the sorted view whose order matches the primary sort key.
+    std::string sortedViewName() const {
+        if (sortKeys.empty()) return "";
+        const std::pair<SortKey, bool>& key = sortKeys[0];
+        if (key.first == SortByDue && !key.second) return "due";
+        if (key.first == SortByPriority && key.second) return "priority";
+        if (key.first == SortByName && !key.second) return "name";
+        return "";
+    }
+
+private:
+    static bool isDate(const std::string& value) {
+        return value.length() == 10 && value[4] == '-' && value[7] == '-' &&
+               std::all_of(value.begin(), value.end(), [](char c) { return isdigit((unsigned char)c) || c == '-'; });
+    }
+
+    // Parses a whole term value as an integer; trailing characters are rejected.
+    static bool parseInteger(const std::string& value, long long& number) {
+        try {
+            size_t used;
+            number = std::stoll(value, &used);
+            return used == value.size();
+        } catch (const std::exception& e) {
+            return false;
+        }
+    }
+
+    static std::vector<std::string> splitList(const std::string& value) {
+        std::vector<std::string> items;
+        for (size_t start = 0; start <= value.size();) {
+            size_t end = value.find(',', start);
+            if (end == std::string::npos) end = value.size();
+            if (end > start) items.push_back(value.substr(start, end - start));
+            start = end + 1;
+        }
+        return items;
+    }
+
+    void tightenDueFrom(const std::string& date, bool exclusive) {
+        if (dueFrom.empty() || date > dueFrom || (date == dueFrom && exclusive)) {
+            dueFrom = date;
+            dueFromExclusive = exclusive;
+        }
+    }
+
+    void tightenDueTo(const std::string& date, bool exclusive) {
+        if (dueTo.empty() || date < dueTo || (date == dueTo && exclusive)) {
+            dueTo = date;
+            dueToExclusive = exclusive;
+        }
+    }
+
+    void parseTerm(const std::string& term) {
+        bool negated = term[0] == '-' && term.size() > 1 && isalpha((unsigned char)term[1]);
+        size_t fieldStart = negated ? 1 : 0;
+        size_t fieldEnd = fieldStart;
+        while (fieldEnd < term.size() && isalpha((unsigned char)term[fieldEnd])) fieldEnd++;
+
+        std::string field = term.substr(fieldStart, fieldEnd - fieldStart);
+        std::string op;
+        if (term.compare(fieldEnd, 2, ">=") == 0 || term.compare(fieldEnd, 2, "<=") == 0) {
+            op = term.substr(fieldEnd, 2);
+        } else if (fieldEnd < term.size() && std::string(":<>=").find(term[fieldEnd]) != std::string::npos) {
+            op = term.substr(fieldEnd, 1);
+        }
+        if (field.empty() || op.empty()) {
+            keywords.push_back(term);
+            return;
+        }
+        std::string value = term.substr(fieldEnd + op.size());
+        if (op == ":") op = "=";
+        if (negated && field != "cat" && field != "category") {
+            error = "Only category terms can be negated: \"" + term + "\".";
+            return;
+        }
+
+        if (field == "status" && op == "=") {
+            if (value == "open" || value == "incomplete") status = OpenOnly;
+            else if (value == "done" || value == "complete") status = CompleteOnly;
+            else error = "Unknown status \"" + value + "\". Use open or done.";
+        } else if ((field == "cat" || field == "category") && op == "=") {
+            std::vector<std::string> categories = splitList(value);
+            if (categories.empty()) error = "Missing category name.";
+            else if (negated) excludedCategories.insert(excludedCategories.end(), categories.begin(), categories.end());
+            else categoryGroups.push_back(categories);
+        } else if (field == "prio" || field == "priority") {
+            long long priority;
+            if (!parseInteger(value, priority) || priority < INT_MIN || priority > INT_MAX) {
+                error = "Invalid priority \"" + value + "\".";
+                return;
+            }
+            long long lower = op == ">" ? priority + 1 : priority;
+            long long upper = op == "<" ? priority - 1 : priority;
+            if (lower > INT_MAX || upper < INT_MIN) {
+                // prio>INT_MAX or prio<INT_MIN: no priority can match.
+                minPriority = INT_MAX;
+                maxPriority = INT_MIN;
+                return;
+            }
+            if (op != "<" && op != "<=") minPriority = std::max(minPriority, int(lower));
+            if (op != ">" && op != ">=") maxPriority = std::min(maxPriority, int(upper));
+        } else if (field == "due") {
+            if (op == "=" && (value == "none" || value == "any")) {
+                (value == "none" ? requireNoDueDate : requireDueDate) = true;
+                return;
+            }
+            if (!isDate(value)) {
+                error = "Invalid due date \"" + value + "\". Please use YYYY-MM-DD format.";
+                return;
+            }
+            requireDueDate = true;
+            if (op == "=" || op == ">=" || op == ">") {
+                tightenDueFrom(value, op == ">");
+            }
+            if (op == "=" || op == "<=" || op == "<") {
+                tightenDueTo(value, op == "<");
+            }
+        } else if (field == "sort" && op == "=") {
+            for (std::string key : splitList(value)) {
+                bool descending = key[0] == '-';
+                if (descending) key = key.substr(1);
+                if (key == "due") sortKeys.push_back(std::make_pair(SortByDue, descending));
+                else if (key == "prio" || key == "priority") sortKeys.push_back(std::make_pair(SortByPriority, descending));
+                else if (key == "name") sortKeys.push_back(std::make_pair(SortByName, descending));
+                else if (key == "status") sortKeys.push_back(std::make_pair(SortByStatus, descending));
+                else error = "Unknown sort key \"" + key + "\". Use due, prio, name or status.";
+            }
+        } else if (field == "limit" && op == "=") {
+            long long number;
+            if (!parseInteger(value, number) || number < 0) {
+                error = "Invalid limit \"" + value + "\".";
+                return;
+            }
+            limit = number;
+        } else {
+            error = "Unknown query term \"" + term + "\".";
+        }
+    }
+};
+
+}  // namespace todo
+
+#endif
@@ -0,0 +1,363 @@
+#ifndef TODO_TASK_STORAGE_H
+#define TODO_TASK_STORAGE_H
+
+#include <climits>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MemoryProfile.h"
+#include "Task.h"
+
+namespace todo {
+
+// Varint and length-prefixed string encoding shared by the archive and
+// session trace formats. Signed values are zigzag-encoded.
+struct BinaryCodec {
+    static void putVarint(std::string& out, unsigned long long value) {
+        while (value >= 0x80) {
+            out.push_back(char((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(char(value));
+    }
+
+    static bool getVarint(const std::string& in, size_t& pos, unsigned long long& value) {
+        value = 0;
+        for (int shift = 0; pos < in.size() && shift < 64; shift += 7) {
+            unsigned char byte = in[pos++];
+            value |= (unsigned long long)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    static bool readVarint(FILE* in, unsigned long long& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = fgetc(in);
+            if (byte == EOF) return false;
+            value |= (unsigned long long)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    static void putString(std::string& out, const std::string& value) {
+        putVarint(out, value.size());
+        out += value;
+    }
+
+    static bool getString(const std::string& in, size_t& pos, std::string& value) {
+        unsigned long long length;
+        if (!getVarint(in, pos, length) || length > in.size() - pos) return false;
+        value = in.substr(pos, length);
+        pos += length;
+        return true;
+    }
+
+    static void putSigned(std::string& out, long long value) {
+        putVarint(out, ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63));
+    }
+
+    static bool getSigned(const std::string& in, size_t& pos, long long& value) {
+        unsigned long long encoded;
+        if (!getVarint(in, pos, encoded)) return false;
+        value = (long long)(encoded >> 1) ^ -(long long)(encoded & 1);
+        return true;
+    }
+};
+
+enum TraceOp {
+    TraceEnd, TraceAddTask, TraceRemoveTask, TraceMarkComplete, TraceSetPriority, TraceSetDueDate,
+    TraceAddCategory, TraceSetReminder, TraceAddDependency, TraceReplaceDependencies, TraceRemoveDependency,
+    TraceRenameCategory, TraceAddNotes, TraceUndo, TraceRedo, TraceArchiveCompleted, TraceStatistics,
+    TraceSearchTasks, TraceTasksByDueDate, TraceRunQuery, TraceSortedViewPage, TraceCompletedHistory,
+    TraceSortedViewRank, TraceSortedViewSelect, TraceOpCount
+};
+
+// Records ToDoList API calls as a compact binary trace: a magic header,
+// then one [op byte][arguments] record per call, closed by TraceEnd and
+// the final state hash so a replay can verify it reached the same state.
+class SessionRecorder {
+private:
+    FILE* out;
+    std::string buffer;
+
+    static void putArg(std::string& encoded, int value) { BinaryCodec::putSigned(encoded, value); }
+    static void putArg(std::string& encoded, const std::string& value) { BinaryCodec::putString(encoded, value); }
+
+    static void putArg(std::string& encoded, const std::vector<int>& values) {
+        BinaryCodec::putVarint(encoded, values.size());
+        for (int value : values) BinaryCodec::putSigned(encoded, value);
+    }
+
+    void flush() {
+        fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+
+public:
+    inline static const std::string magic = "TODOTRACE2\n";
+
+    SessionRecorder() : out(nullptr) {}
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    bool start(const std::string& path) {
+        out = fopen(path.c_str(), "wb");
+        if (!out) return false;
+        buffer = magic;
+        return true;
+    }
+
+    bool active() const { return out != nullptr; }
+
+    template <typename... Args>
+    void record(TraceOp op, const Args&... args) {
+        if (!active()) return;
+        MemoryScope scope(MemTrace);
+        buffer.push_back(char(op));
+        (putArg(buffer, args), ...);
+        if (buffer.size() >= 64 * 1024) flush();
+    }
+
+    void finish(unsigned long long stateHash) {
+        if (!active()) return;
+        buffer.push_back(char(TraceEnd));
+        BinaryCodec::putVarint(buffer, stateHash);
+        flush();
+        fclose(out);
+        out = nullptr;
+    }
+};
+
+// Reads a trace written by SessionRecorder. The whole file is loaded up
+// front so decoding does not touch the disk while a replay is timed.
+class TraceReader {
+private:
+    std::string data;
+    size_t pos;
+    bool corrupt;
+
+public:
+    TraceReader() : pos(0), corrupt(false) {}
+
+    bool open(const std::string& path) {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return false;
+        char chunk[64 * 1024];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+            data.append(chunk, read);
+        }
+        fclose(in);
+        if (data.compare(0, SessionRecorder::magic.size(), SessionRecorder::magic) != 0) return false;
+        pos = SessionRecorder::magic.size();
+        return true;
+    }
+
+    bool next(TraceOp& op) {
+        if (corrupt || pos >= data.size()) return false;
+        unsigned char code = data[pos++];
+        if (code >= TraceOpCount) {
+            corrupt = true;
+            return false;
+        }
+        op = TraceOp(code);
+        return true;
+    }
+
+    bool failed() const { return corrupt; }
+
+    int getInt() {
+        long long value = 0;
+        if (!BinaryCodec::getSigned(data, pos, value) || value < INT_MIN || value > INT_MAX) {
+            corrupt = true;
+            return 0;
+        }
+        return int(value);
+    }
+
+    std::string getString() {
+        std::string value;
+        if (!BinaryCodec::getString(data, pos, value)) corrupt = true;
+        return value;
+    }
+
+    std::vector<int> getIntList() {
+        unsigned long long count = 0;
+        std::vector<int> values;
+        if (!BinaryCodec::getVarint(data, pos, count) || count > data.size() - pos) {
+            corrupt = true;
+            return values;
+        }
+        for (unsigned long long i = 0; i < count; ++i) values.push_back(getInt());
+        return values;
+    }
+
+    unsigned long long getHash() {
+        unsigned long long value = 0;
+        if (!BinaryCodec::getVarint(data, pos, value)) corrupt = true;
+        return value;
+    }
+};
+
+// Append-only cold segment for completed tasks. Each record is
+// [varint length][payload]; strings are length-prefixed and dates are packed
+// as YYYYMMDD varints. The record index is only built when the archive is
+// counted.
+class TaskArchive {
+private:
+    std::string path;
+    std::vector<long> offsets;
+    bool indexLoaded;
+    std::string pending;
+    std::vector<long> pendingOffsets;
+
+    static unsigned long long packDate(const std::string& date) {
+        if (date.length() != 10) return 0;
+        return std::stoull(date.substr(0, 4) + date.substr(5, 2) + date.substr(8, 2));
+    }
+
+    static std::string unpackDate(unsigned long long packed) {
+        if (packed == 0) return "";
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%04llu-%02llu-%02llu", packed / 10000, (packed / 100) % 100, packed % 100);
+        return buffer;
+    }
+
+    static long segmentSize(FILE* in) {
+        fseek(in, 0, SEEK_END);
+        long size = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        return size;
+    }
+
+    // Reads the length prefix at the current position and checks that the
+    // record fits in the rest of the segment, so a corrupt length is caught
+    // before anything is allocated for it.
+    static bool readLength(FILE* in, long fileSize, unsigned long long& length) {
+        return BinaryCodec::readVarint(in, length) && length <= (unsigned long long)(fileSize - ftell(in));
+    }
+
+    // Reads the record at the current position. Returns false on a truncated
+    // record.
+    static bool readPayload(FILE* in, long fileSize, std::string& payload) {
+        unsigned long long length;
+        if (!readLength(in, fileSize, length)) return false;
+        payload.resize(length);
+        return length == 0 || fread(&payload[0], 1, length, in) == length;
+    }
+
+    static bool decode(const std::string& payload, Task& task, std::string& archivedOn) {
+        size_t pos = 0;
+        long long priority;
+        unsigned long long dueDate, reminderDate, archivedDate, categoryCount;
+        task = Task("", "Complete");
+        if (!BinaryCodec::getString(payload, pos, task.name) || !BinaryCodec::getSigned(payload, pos, priority)) return false;
+        task.priority = int(priority);
+        if (!BinaryCodec::getVarint(payload, pos, dueDate) || !BinaryCodec::getVarint(payload, pos, reminderDate) ||
+            !BinaryCodec::getVarint(payload, pos, archivedDate) || !BinaryCodec::getVarint(payload, pos, categoryCount)) return false;
+        task.dueDate = unpackDate(dueDate);
+        task.reminderDate = unpackDate(reminderDate);
+        archivedOn = unpackDate(archivedDate);
+        for (unsigned long long i = 0; i < categoryCount; ++i) {
+            std::string category;
+            if (!BinaryCodec::getString(payload, pos, category)) return false;
+            task.categories.push_back(category);
+        }
+        return BinaryCodec::getString(payload, pos, task.notes);
+    }
+
+    void loadIndex() {
+        if (indexLoaded) return;
+        offsets.clear();
+        indexLoaded = true;
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return;
+        long fileSize = segmentSize(in);
+        unsigned long long length;
+        for (long offset = 0; offset < fileSize && readLength(in, fileSize, length); offset = ftell(in)) {
+            offsets.push_back(offset);
+            fseek(in, (long)length, SEEK_CUR);
+        }
+        fclose(in);
+    }
+
+public:
+    explicit TaskArchive(const std::string& segmentPath) : path(segmentPath), indexLoaded(false) {}
+
+    // Encodes a record into the pending batch; nothing touches the segment
+    // until commit() writes the whole batch with a single open.
+    void stage(const Task& task, const std::string& archivedOn) {
+        std::string payload;
+        BinaryCodec::putString(payload, task.name);
+        BinaryCodec::putSigned(payload, task.priority);
+        BinaryCodec::putVarint(payload, packDate(task.dueDate));
+        BinaryCodec::putVarint(payload, packDate(task.reminderDate));
+        BinaryCodec::putVarint(payload, packDate(archivedOn));
+        BinaryCodec::putVarint(payload, task.categories.size());
+        for (const std::string& category : task.categories) {
+            BinaryCodec::putString(payload, category);
+        }
+        BinaryCodec::putString(payload, task.notes);
+
+        pendingOffsets.push_back(pending.size());
+        BinaryCodec::putVarint(pending, payload.size());
+        pending += payload;
+    }
+
+    // Appends the staged records. Either the whole batch is written or the
+    // call fails; the batch is discarded in both cases.
+    bool commit() {
+        if (pending.empty()) return true;
+        FILE* out = fopen(path.c_str(), "ab");
+        bool written = out != nullptr;
+        if (written) {
+            fseek(out, 0, SEEK_END);
+            long base = ftell(out);
+            written = fwrite(pending.data(), 1, pending.size(), out) == pending.size();
+            written = fclose(out) == 0 && written;
+            if (written && indexLoaded) {
+                for (long offset : pendingOffsets) offsets.push_back(base + offset);
+            }
+        }
+        pending.clear();
+        pendingOffsets.clear();
+        return written;
+    }
+
+    size_t size() {
+        loadIndex();
+        return offsets.size();
+    }
+
+    // Streams every record in order through visit(task, archivedOn) with a
+    // single open of the segment. Returns false if any record could not be
+    // decoded, which skips it, or if the segment ends in a truncated record.
+    template <typename Visitor>
+    bool forEach(Visitor visit) {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return true;
+        long fileSize = segmentSize(in);
+        bool allDecoded = true;
+        std::string payload;
+        std::string archivedOn;
+        Task task("");
+        while (ftell(in) < fileSize) {
+            if (!readPayload(in, fileSize, payload)) {
+                allDecoded = false;
+                break;
+            }
+            if (decode(payload, task, archivedOn)) visit(task, archivedOn);
+            else allDecoded = false;
+        }
+        fclose(in);
+        return allDecoded;
+    }
+};
+
+}  // namespace todo
+
+#endif
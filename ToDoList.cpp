@@ -1,270 +1,141 @@
 #include <iostream>
 #include <vector>
-#include <stack>
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
+#include <string>
 #include <ctime>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <cstdlib>
+#include <cstdio>
 #include <thread>
-using namespace std;
-
-class Task {
-public:
-    string name;
-    string status;
-    int priority;
-    string dueDate;
-    vector<string> categories;
-    string reminderDate;
-    unordered_set<int> dependencies;
-    string notes;
-
-    Task(const string& taskName, const string& taskStatus = "Incomplete")
-        : name(taskName), status(taskStatus), priority(0) {}
-};
-
-class ToDoList {
-private:
-    vector<Task> tasks;
-    stack<pair<string, Task> > undoStack;
-    stack<pair<string, Task> > redoStack;
-    priority_queue<pair<int, int> > priorityQueue;
-    unordered_map<string, int> categoryCount;
-
-public:
-   void addDependency(int dependentIndex, int dependencyIndex) {
-        if (dependentIndex >= 0 && dependentIndex < tasks.size() && dependencyIndex >= 0 && dependencyIndex < tasks.size()) {
-            tasks[dependentIndex].dependencies.insert(dependencyIndex);
-            cout << "Task \"" << tasks[dependentIndex].name << "\" now depends on task \"" << tasks[dependencyIndex].name << "\"." << endl;
-        } else {
-            cout << "Invalid task indices. Please provide valid task indices." << endl;
-        }
-    }
-
-    bool checkEmpty(){
-        if (tasks.empty()){
-            cout << "No tasks in the list. Please add a task first." << endl;
-            return true;
-        }
-        return false;
-    }
-
-    void addTask(const string& taskName) {
-        Task newTask(taskName);
-        tasks.push_back(newTask);
-        undoStack.push(make_pair("add", newTask));
-        redoStack = stack<pair<string, Task> >();
-        priorityQueue.push(make_pair(0, tasks.size() - 1));
-        updateCategoryCount(newTask);
-    }
-
-    void removeTask(int taskIndex) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            Task removedTask = tasks[taskIndex];
-            tasks.erase(tasks.begin() + taskIndex);
-            undoStack.push(make_pair("remove", removedTask));
-            redoStack = stack<pair<string, Task> >();
-
-            updateCategoryCount(removedTask, true);
-        }
-    }
-
-    void markComplete(int taskIndex) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            tasks[taskIndex].status = "Complete";
-            undoStack.push(make_pair("mark_incomplete", tasks[taskIndex]));
-            redoStack = stack<pair<string, Task> >();
-        }
-    }
-
-    void setTaskPriority(int taskIndex, int priority) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            int oldPriority = tasks[taskIndex].priority;
-            tasks[taskIndex].priority = priority;
-
-            if (oldPriority != priority) {
-                priorityQueue.push(make_pair(priority, taskIndex));
-            }
-        } else {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
-        }
-    }
-
-    void setTaskDueDate(int taskIndex, const string& dueDate) {
-        if (checkEmpty()) return;
-        if (taskIndex < 0 || taskIndex >= tasks.size()) {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
-            return;
-        }
+#include <algorithm>
+#include <limits>
 
-        if (dueDate.length() != 10 || dueDate[4] != '-' || dueDate[7] != '-') {
-            cout << "Invalid date format. Please use YYYY-MM-DD format." << endl;
-            return;
-        }
-
-        try {
-            int year = stoi(dueDate.substr(0, 4));
-            int month = stoi(dueDate.substr(5, 2));
-            int day = stoi(dueDate.substr(8, 2));
-
-            if (year < 2024 || month < 1 || month > 12 || day < 1 || day > 31) {
-                cout << "Invalid date values." << endl;
-                return;
-            }
-
-            bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-            int daysInMonth[] = {31, (isLeapYear ? 29 : 28), 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-            if (day > daysInMonth[month - 1]) {
-                cout << "Invalid day for the given month." << endl;
-                return;
-            }
-
-            tasks[taskIndex].dueDate = dueDate;
-            cout << "Due date set successfully." << endl;
-        }
-        catch (const exception& e) {
-            cout << "Invalid date format. Please use YYYY-MM-DD format." << endl;
-        }
+// This file is the one translation unit that installs the profiling allocator.
+#define TODO_MEMORY_PROFILE_IMPLEMENTATION
+#include "ToDoList.h"
+using namespace std;
+using namespace todo;
+
+// Console front end for the ToDoList engine. Everything that reads from cin
+// or writes to cout lives here; the engine itself only returns data.
+
+#ifdef TODO_MEMORY_PROFILE
+void displayMemoryReport() {
+    static const char* tagNames[MemTagCount] = {
+        "Other", "Tasks", "Dependencies", "Undo/Redo", "Priority Queue", "Indexes", "Queries", "Archive", "Trace"};
+
+    // Copy the counters first so the report's own output does not skew them.
+    MemoryStats tags[MemTagCount];
+    copy(MemoryProfile::tags, MemoryProfile::tags + MemTagCount, tags);
+    MemoryStats total = MemoryProfile::total;
+    vector<OperationStats> operations(MemoryProfile::operations, MemoryProfile::operations + MemoryProfile::operationCount);
+
+    if (!MemoryProfile::allocatorInstalled) {
+        cout << "The profiling allocator is not installed, so no allocations were counted." << endl;
+        cout << "Define TODO_MEMORY_PROFILE_IMPLEMENTATION in one source file before including MemoryProfile.h." << endl;
+        return;
     }
 
-    void addTaskCategory(int taskIndex, const string& category) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            tasks[taskIndex].categories.push_back(category);
-            updateCategoryCount(tasks[taskIndex]);
-        } else {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
-        }
+    cout << "Memory by subsystem:" << endl;
+    cout << left << setw(16) << "Subsystem" << right << setw(14) << "Current (B)" << setw(14) << "Peak (B)"
+         << setw(14) << "Live allocs" << setw(14) << "Total allocs" << endl;
+    for (int tag = 0; tag < MemTagCount; ++tag) {
+        cout << left << setw(16) << tagNames[tag] << right << setw(14) << tags[tag].currentBytes << setw(14) << tags[tag].peakBytes
+             << setw(14) << tags[tag].liveAllocations << setw(14) << tags[tag].allocations << endl;
     }
-
-    void setReminder(int taskIndex, const string& reminderDate) {
-        if (checkEmpty()) return;
-        if (taskIndex < 0 || taskIndex >= tasks.size()) {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
-            return;
-        }
-
-        if (reminderDate.length() != 10 || reminderDate[4] != '-' || reminderDate[7] != '-') {
-            cout << "Invalid date format. Please use YYYY-MM-DD format." << endl;
-            return;
-        }
-
-        try {
-            int year = stoi(reminderDate.substr(0, 4));
-            int month = stoi(reminderDate.substr(5, 2));
-            int day = stoi(reminderDate.substr(8, 2));
-
-            if (year < 2024 || month < 1 || month > 12 || day < 1 || day > 31) {
-                cout << "Invalid date values." << endl;
-                return;
-            }
-
-            bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-            int daysInMonth[] = {31, (isLeapYear ? 29 : 28), 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-            if (day > daysInMonth[month - 1]) {
-                cout << "Invalid day for the given month." << endl;
-                return;
-            }
-
-            tasks[taskIndex].reminderDate = reminderDate;
-            cout << "Reminder set for task \"" << tasks[taskIndex].name << "\" on " << reminderDate << endl;
-        }
-        catch (const exception& e) {
-            cout << "Invalid date format. Please use YYYY-MM-DD format." << endl;
-        }
+    cout << left << setw(16) << "Total" << right << setw(14) << total.currentBytes << setw(14) << total.peakBytes
+         << setw(14) << total.liveAllocations << setw(14) << total.allocations << endl;
+
+    cout << "\nAllocations by operation:" << endl;
+    cout << left << setw(24) << "Operation" << right << setw(10) << "Calls" << setw(14) << "Allocs"
+         << setw(14) << "Allocs/call" << setw(14) << "Bytes/call" << setw(14) << "Peak (B)" << endl;
+    for (const OperationStats& stats : operations) {
+        cout << left << setw(24) << stats.name << right << setw(10) << stats.calls << setw(14) << stats.allocations
+             << setw(14) << fixed << setprecision(1) << double(stats.allocations) / stats.calls
+             << setw(14) << double(stats.bytes) / stats.calls << setw(14) << stats.peakBytes << endl;
     }
+    cout << defaultfloat;
+}
+#else
+void displayMemoryReport() {
+    cout << "Memory profiling is disabled. Rebuild with -DTODO_MEMORY_PROFILE to enable it." << endl;
+}
+#endif
 
+// Prints the message for a failed call and returns whether it succeeded.
+bool reportStatus(TodoStatus status) {
+    if (status == StatusOk) return true;
+    cout << statusMessage(status) << endl;
+    return false;
+}
 
+bool checkEmpty(const ToDoList& todoList) {
+    return !reportStatus(todoList.empty() ? StatusEmptyList : StatusOk);
+}
 
-    void updateCategoryCount(const Task& task, bool decrement = false) {
+void displayTasks(const ToDoList& todoList) {
+    for (ToDoList::const_iterator it = todoList.begin(); it != todoList.end(); ++it) {
+        const Task& task = *it;
+        cout << it.index() + 1 << ". [" << task.status << "] " << task.name << endl;
+        cout << "   Priority: " << task.priority << endl;
+        cout << "   Due Date: " << task.dueDate << endl;
+        cout << "   Notes:" << task.notes << endl;
+        cout << "   Categories: ";
         for (const string& category : task.categories) {
-            if (decrement) {
-                categoryCount[category]--;
-            } else {
-                categoryCount[category]++;
-            }
+            cout << category << ", ";
         }
+        cout << "   Reminder: " << task.reminderDate << endl;
+        cout << endl;
     }
+}
 
-    void displayCategoryCount() {
-        cout << "Category Count:" << endl;
-        for (const auto& entry : categoryCount) {
-            cout << entry.first << ": " << entry.second << " tasks" << endl;
-        }
-    }
-
-    void undo() {
-        if (!undoStack.empty()) {
-            pair<string, Task> action = undoStack.top();
-            undoStack.pop();
-
-            if (action.first == "add") {
-                tasks.pop_back();
-                priorityQueue.pop();  
-                updateCategoryCount(action.second, true);
-            } else if (action.first == "remove") {
-                tasks.push_back(action.second);
-                priorityQueue.push(make_pair(tasks.back().priority, tasks.size() - 1));
-                updateCategoryCount(action.second);
-            } else if (action.first == "mark_incomplete") {
-                action.second.status = "Incomplete";
-            }
+void displayStatistics(ToDoList& todoList) {
+    TaskStatistics stats = todoList.statistics();
+    cout << "Total Tasks: " << stats.total << endl;
+    cout << "Completed Tasks: " << stats.completed << endl;
+    cout << "Archived Tasks: " << stats.archived << endl;
+}
 
-            redoStack.push(action);
-        }
+void displayCategoryCount(const ToDoList& todoList) {
+    cout << "Category Count:" << endl;
+    for (const auto& entry : todoList.getCategoryCounts()) {
+        cout << entry.first << ": " << entry.second << " tasks" << endl;
     }
+}
 
-    void redo() {
-        if (!redoStack.empty()) {
-            pair<string, Task> action = redoStack.top();
-            redoStack.pop();
-
-            if (action.first == "add") {
-                tasks.push_back(action.second);
-                priorityQueue.push(make_pair(tasks.back().priority, tasks.size() - 1));
-                updateCategoryCount(action.second);
-            } else if (action.first == "remove") {
-                tasks.pop_back();
-                priorityQueue.pop();  
-                updateCategoryCount(action.second, true);
-            } else if (action.first == "mark_incomplete") {
-                action.second.status = "Complete";
-            }
+void setTaskDueDate(ToDoList& todoList, int taskIndex, const string& dueDate) {
+    if (reportStatus(todoList.setTaskDueDate(taskIndex, dueDate))) {
+        cout << "Due date set successfully." << endl;
+    }
+}
 
-            undoStack.push(action);
-        }
+void setReminder(ToDoList& todoList, int taskIndex, const string& reminderDate) {
+    if (reportStatus(todoList.setReminder(taskIndex, reminderDate))) {
+        cout << "Reminder set for task \"" << todoList.getTask(taskIndex).name << "\" on " << reminderDate << endl;
     }
+}
 
-    void displayTasks() {
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            cout << i + 1 << ". [" << tasks[i].status << "] " << tasks[i].name << endl;
-            cout << "   Priority: " << tasks[i].priority << endl;
-            cout << "   Due Date: " << tasks[i].dueDate << endl;
-            cout << "   Notes:" << tasks[i].notes   << endl;                                     
-            cout << "   Categories: ";
-            for (const string& category : tasks[i].categories) {
-                cout << category << ", ";
+// Replaces a task's dependencies and echoes each link that was made.
+void replaceDependencies(ToDoList& todoList, int taskIndex, const vector<int>& dependencyIndices) {
+    TodoStatus status = todoList.replaceDependencies(taskIndex, dependencyIndices);
+    if (todoList.hasTask(taskIndex)) {
+        const Task& task = todoList.getTask(taskIndex);
+        for (int dependencyIndex : dependencyIndices) {
+            if (task.dependencies.count(dependencyIndex)) {
+                cout << "Task \"" << task.name << "\" now depends on task \"" << todoList.getTask(dependencyIndex).name << "\"." << endl;
             }
-            cout << "   Reminder: " << tasks[i].reminderDate << endl;
-            cout << endl;
         }
     }
+    reportStatus(status);
+}
 
-void setTaskDependencies(int taskIndex) {
-    if (taskIndex >= 0 && taskIndex < tasks.size()) {
-        cout << "Enter indices of tasks that " << tasks[taskIndex].name << " depends on (-1 to stop): ";
-
-        tasks[taskIndex].dependencies.clear();
+void setTaskDependencies(ToDoList& todoList, int taskIndex) {
+    if (todoList.hasTask(taskIndex)) {
+        cout << "Enter indices of tasks that " << todoList.getTask(taskIndex).name << " depends on (-1 to stop): ";
 
+        vector<int> dependencyIndices;
         int dependencyIndex;
-        string input;
         while (true) {
             if (!(cin >> dependencyIndex)) {
                 cin.clear();
@@ -272,230 +143,429 @@ void setTaskDependencies(int taskIndex) {
                 cout << "Invalid input. Please enter a number or -1 to stop." << endl;
                 continue;
             }
-            
+
             if (dependencyIndex == -1) {
                 break;
             }
-            
+
             dependencyIndex--;
             if (dependencyIndex == taskIndex) {
                 cout << "Task cannot depend on itself." << endl;
                 continue;
             }
-            
-            if (dependencyIndex >= 0 && dependencyIndex < tasks.size()) {
-                addDependency(taskIndex, dependencyIndex);
+
+            if (todoList.hasTask(dependencyIndex)) {
+                dependencyIndices.push_back(dependencyIndex);
             } else {
                 cout << "Invalid task index. Please provide a valid task index or -1 to stop." << endl;
             }
-            
+
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
+        replaceDependencies(todoList, taskIndex, dependencyIndices);
     } else {
-        cout << "Invalid task index. Please provide a valid task index." << endl;
+        reportStatus(StatusInvalidIndex);
     }
 }
 
-void displayTaskDependencies(int taskIndex) {
-    if (taskIndex >= 0 && taskIndex < tasks.size()) {
-        const Task& task = tasks[taskIndex];
+void updateDependencies(ToDoList& todoList, int taskIndex) {
+    if (todoList.hasTask(taskIndex)) {
+        cout << "Enter updated indices of tasks that " << todoList.getTask(taskIndex).name << " depends on (-1 to stop): ";
+        vector<int> dependencyIndices;
+        int dependencyIndex;
+        while (true) {
+            cin >> dependencyIndex;
+            if (dependencyIndex == -1) {
+                break;
+            }
+            if (todoList.hasTask(dependencyIndex - 1)) {
+                dependencyIndices.push_back(dependencyIndex - 1);
+            } else {
+                cout << "Invalid task index. Please provide a valid task index or -1 to stop." << endl;
+            }
+        }
+        replaceDependencies(todoList, taskIndex, dependencyIndices);
+    } else {
+        reportStatus(StatusInvalidIndex);
+    }
+}
+
+void displayTaskDependencies(const ToDoList& todoList, int taskIndex) {
+    if (todoList.hasTask(taskIndex)) {
+        const Task& task = todoList.getTask(taskIndex);
         cout << "Dependencies for task \"" << task.name << "\": " << endl;
         for (int dependencyIndex : task.dependencies) {
-                if((tasks[dependencyIndex].name).length()!=0)                                            
-            cout << "- " << tasks[dependencyIndex].name << endl;
+            if (todoList.hasTask(dependencyIndex))
+                cout << "- " << todoList.getTask(dependencyIndex).name << endl;
         }
     } else {
-        cout << "Invalid task index. Please provide a valid task index." << endl;
+        reportStatus(StatusInvalidIndex);
     }
 }
 
-    void visualizeDependencyGraph() {
-        cout << "\nDependency Graph:\n";
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            cout << "\n" << tasks[i].name << "\n";
-            
-            for (int depIndex : tasks[i].dependencies) {
-                cout << "|\n";
-                cout << "└─> " << tasks[depIndex].name << "\n";
-            }
-            
-            if (!tasks[i].dependencies.empty()) {
-                cout << "\n";
-            }
+void visualizeDependencyGraph(const ToDoList& todoList) {
+    cout << "\nDependency Graph:\n";
+    for (const Task& task : todoList) {
+        cout << "\n" << task.name << "\n";
+
+        for (int depIndex : task.dependencies) {
+            if (!todoList.hasTask(depIndex)) continue;
+            cout << "|\n";
+            cout << "└─> " << todoList.getTask(depIndex).name << "\n";
         }
-    }
 
-    void visualizeTaskDependencies() {
-        cout << "Task Dependencies Visualization:" << endl;
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            cout << "Task \"" << tasks[i].name << "\" depends on: ";
-            for (int dependencyIndex : tasks[i].dependencies) {
-                cout << tasks[dependencyIndex].name << ", ";
-            }
-            cout << endl;
+        if (!task.dependencies.empty()) {
+            cout << "\n";
+        }
+    }
+}
 
-            visualizeDependencyGraph();
+void visualizeTaskDependencies(const ToDoList& todoList) {
+    cout << "Task Dependencies Visualization:" << endl;
+    for (const Task& task : todoList) {
+        cout << "Task \"" << task.name << "\" depends on: ";
+        for (int dependencyIndex : task.dependencies) {
+            if (todoList.hasTask(dependencyIndex)) cout << todoList.getTask(dependencyIndex).name << ", ";
         }
+        cout << endl;
+
+        visualizeDependencyGraph(todoList);
     }
+}
 
-    void removeDependency(int dependentIndex, int dependencyIndex) {
-        if (checkEmpty()) return;
-        if (dependentIndex >= 0 && dependentIndex < tasks.size() && dependencyIndex >= 0 && dependencyIndex < tasks.size()) {
-            tasks[dependentIndex].dependencies.erase(dependencyIndex);
-        } else {
-            cout << "Invalid task indices. Please provide valid task indices." << endl;
+void changeTaskCategory(ToDoList& todoList, int taskIndex) {
+    if (checkEmpty(todoList)) return;
+    if (!todoList.hasTask(taskIndex)) {
+        reportStatus(StatusInvalidIndex);
+        return;
+    }
+    const Task& task = todoList.getTask(taskIndex);
+    cout << "Current categories for task \"" << task.name << "\":" << endl;
+    if (task.categories.empty()) {
+        cout << "No categories assigned." << endl;
+        return;
+    }
+
+    for (size_t i = 0; i < task.categories.size(); i++) {
+        cout << i + 1 << ". " << task.categories[i] << endl;
+    }
+
+    cout << "Enter the index of category to modify (1-" << task.categories.size() << "): ";
+    int categoryIndex;
+    cin >> categoryIndex;
+    categoryIndex--;
+
+    if (categoryIndex >= 0 && categoryIndex < (int)task.categories.size()) {
+        cout << "Enter new category name: ";
+        cin.ignore();
+        string newCategory;
+        getline(cin, newCategory);
+        if (reportStatus(todoList.renameTaskCategory(taskIndex, categoryIndex, newCategory))) {
+            cout << "Category updated successfully!" << endl;
         }
+    } else {
+        reportStatus(StatusInvalidCategoryIndex);
     }
+}
 
-    void updateDependencies(int taskIndex) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            tasks[taskIndex].dependencies.clear();
-            cout << "Enter updated indices of tasks that " << tasks[taskIndex].name << " depends on (-1 to stop): ";
-            int dependencyIndex;
-            while (true) {
-                cin >> dependencyIndex;
-                if (dependencyIndex == -1) {
-                    break;
-                }
-                if (dependencyIndex >= 0 && dependencyIndex <= tasks.size()) {
-                    addDependency(taskIndex, dependencyIndex-1);                                                //update
-                } else {
-                    cout << "Invalid task index. Please provide a valid task index or -1 to stop." << endl;
-                }
-            }
+void taskSearch(ToDoList& todoList, const string& keyword) {
+    vector<int> results = todoList.searchTasks(keyword);
+    cout << "Search results for keyword \"" << keyword << "\":" << endl;
+    for (int taskIndex : results) {
+        cout << taskIndex + 1 << ". " << todoList.getTask(taskIndex).name << endl;
+    }
+}
+
+void displayTaskLine(const ToDoList& todoList, int taskIndex) {
+    const Task& task = todoList.getTask(taskIndex);
+    cout << taskIndex + 1 << ". [" << task.status << "] " << task.name
+         << " (Priority: " << task.priority << ", Due: " << (task.dueDate.empty() ? "-" : task.dueDate) << ")" << endl;
+}
+
+void displayQueryResults(ToDoList& todoList, const string& text) {
+    vector<int> results;
+    string error;
+    if (todoList.runQuery(text, results, error) != StatusOk) {
+        cout << error << endl;
+        return;
+    }
+    cout << "Query results for \"" << text << "\" (" << results.size() << " tasks):" << endl;
+    for (int taskIndex : results) {
+        displayTaskLine(todoList, taskIndex);
+    }
+}
+
+void displaySortedView(ToDoList& todoList, const string& view, int pageNumber, int pageSize = 10) {
+    int pageCount = max<int>(1, (todoList.getTaskCount() + pageSize - 1) / pageSize);
+    if (pageNumber < 1 || pageNumber > pageCount) {
+        cout << "Invalid page. Please choose a page between 1 and " << pageCount << "." << endl;
+        return;
+    }
+    int from = (pageNumber - 1) * pageSize;
+    vector<int> page;
+    if (!reportStatus(todoList.sortedViewPage(view, from, pageSize, page))) return;
+    cout << "Tasks by " << view << " (page " << pageNumber << " of " << pageCount << "):" << endl;
+    for (size_t i = 0; i < page.size(); ++i) {
+        cout << "#" << from + i + 1 << "  ";
+        displayTaskLine(todoList, page[i]);
+    }
+}
+
+void dueDateAlerts(ToDoList& todoList) {
+    if (todoList.empty()) {
+        cout << "No tasks in the list. No due date alerts to show." << endl;
+        return;
+    }
+
+    vector<int> dueTasks = todoList.tasksByDueDate();
+    if (dueTasks.empty()) {
+        cout << "No tasks have due dates set. You can relax for now! 😊" << endl;
+        return;
+    }
+
+    cout << "Due Date Alerts:" << endl;
+    time_t currentTime = time(nullptr);
+    for (int taskIndex : dueTasks) {
+        const Task& task = todoList.getTask(taskIndex);
+        struct tm dueDateStruct = {};
+        stringstream dueDateStream(task.dueDate);
+        dueDateStream >> get_time(&dueDateStruct, "%Y-%m-%d");
+        string line = task.name + " (Due: " + task.dueDate + ")";
+        if (mktime(&dueDateStruct) < currentTime) {
+            cout << "⚠️  OVERDUE: " << line << endl;
         } else {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
+            cout << "📅 Upcoming: " << line << endl;
         }
     }
+}
 
-    void taskSearch(const string& keyword) {
-        cout << "Search results for keyword \"" << keyword << "\":" << endl;
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            if (tasks[i].name.find(keyword) != string::npos || tasks[i].notes.find(keyword) != string::npos) {
-                cout << i + 1 << ". " << tasks[i].name << endl;
-            }
-        }
+void displayCompletedHistory(ToDoList& todoList, const string& keyword = "") {
+    vector<ArchivedTask> history;
+    TodoStatus status = todoList.completedHistory(keyword, history);
+    if (history.empty() && status == StatusOk) {
+        cout << (keyword.empty() ? "No archived tasks yet." : "No archived tasks match that keyword.") << endl;
+        return;
     }
 
-    void displayStatistics() {
-        int totalTasks = tasks.size();
-        int completedTasks = 0;
-        for (const Task& task : tasks) {
-            if (task.status == "Complete") {
-                completedTasks++;
-            }
-        }
-        cout << "Total Tasks: " << totalTasks << endl;
-        cout << "Completed Tasks: " << completedTasks << endl;
+    cout << "Completed Task History:" << endl;
+    for (const ArchivedTask& entry : history) {
+        cout << "✔ " << entry.task.name << " (Archived: " << entry.archivedOn << ")" << endl;
+        cout << "   Priority: " << entry.task.priority << endl;
+        cout << "   Due Date: " << entry.task.dueDate << endl;
+        cout << "   Notes:" << entry.task.notes << endl;
+        cout << "   Categories: ";
+        for (const string& category : entry.task.categories) {
+            cout << category << ", ";
+        }
+        cout << endl;
     }
+    reportStatus(status);
+}
 
-    void dueDateAlerts() {
+// Decodes one recorded call and runs it. Multi-argument calls decode into
+// locals first since argument evaluation order is unspecified.
+bool replayCall(ToDoList& todoList, TraceOp op, TraceReader& trace) {
+    switch (op) {
+        case TraceAddTask: todoList.addTask(trace.getString()); break;
+        case TraceRemoveTask: todoList.removeTask(trace.getInt()); break;
+        case TraceMarkComplete: todoList.markComplete(trace.getInt()); break;
+        case TraceUndo: todoList.undo(); break;
+        case TraceRedo: todoList.redo(); break;
+        case TraceArchiveCompleted: todoList.archiveCompletedTasks(); break;
+        case TraceStatistics: todoList.statistics(); break;
+        case TraceSearchTasks: todoList.searchTasks(trace.getString()); break;
+        case TraceTasksByDueDate: todoList.tasksByDueDate(); break;
 
-        if (tasks.empty()) {
-            cout << "No tasks in the list. No due date alerts to show." << endl;
-            return;
+        case TraceCompletedHistory: {
+            vector<ArchivedTask> history;
+            todoList.completedHistory(trace.getString(), history);
+            break;
         }
 
-        bool hasDueDates = false;
-        for (const Task& task : tasks) {
-            if (!task.dueDate.empty()) {
-                hasDueDates = true;
-                break;
-            }
+        case TraceRunQuery: {
+            vector<int> results;
+            string error;
+            todoList.runQuery(trace.getString(), results, error);
+            break;
         }
 
-        if (!hasDueDates) {
-            cout << "No tasks have due dates set. You can relax for now! 😊" << endl;
-            return;
+        case TraceSetPriority: {
+            int taskIndex = trace.getInt();
+            int priority = trace.getInt();
+            todoList.setTaskPriority(taskIndex, priority);
+            break;
         }
 
-        cout << "Due Date Alerts:" << endl;
-        time_t currentTime = time(nullptr);
+        case TraceSetDueDate: {
+            int taskIndex = trace.getInt();
+            string dueDate = trace.getString();
+            todoList.setTaskDueDate(taskIndex, dueDate);
+            break;
+        }
 
-        vector<pair<time_t, string>> dueDates;
-        
-        for (const Task& task : tasks) {
-            if (!task.dueDate.empty()) {
-                struct tm dueDateStruct = {};
-                stringstream dueDateStream(task.dueDate);
-                dueDateStream >> get_time(&dueDateStruct, "%Y-%m-%d");
-                time_t dueTime = mktime(&dueDateStruct);
-                dueDates.push_back({dueTime, task.name + " (Due: " + task.dueDate + ")"});
-            }
+        case TraceAddCategory: {
+            int taskIndex = trace.getInt();
+            string category = trace.getString();
+            todoList.addTaskCategory(taskIndex, category);
+            break;
         }
 
-        sort(dueDates.begin(), dueDates.end());
+        case TraceSetReminder: {
+            int taskIndex = trace.getInt();
+            string reminderDate = trace.getString();
+            todoList.setReminder(taskIndex, reminderDate);
+            break;
+        }
 
-        for (const auto& task : dueDates) {
-            if (task.first < currentTime) {
-                cout << "⚠️  OVERDUE: " << task.second << endl;
-            } else {
-                cout << "📅 Upcoming: " << task.second << endl;
-            }
+        case TraceAddNotes: {
+            int taskIndex = trace.getInt();
+            string notes = trace.getString();
+            todoList.addTaskNotes(taskIndex, notes);
+            break;
         }
-    }
 
+        case TraceAddDependency: {
+            int dependentIndex = trace.getInt();
+            int dependencyIndex = trace.getInt();
+            todoList.addDependency(dependentIndex, dependencyIndex);
+            break;
+        }
 
-    void addTaskNotes(int taskIndex, const string& notes) {
-        if (checkEmpty()) return;
-        if (taskIndex >= 0 && taskIndex < tasks.size()) {
-            tasks[taskIndex].notes += notes;
-        } else {
-            cout << "Invalid task index. Please provide a valid task index." << endl;
+        case TraceRemoveDependency: {
+            int dependentIndex = trace.getInt();
+            int dependencyIndex = trace.getInt();
+            todoList.removeDependency(dependentIndex, dependencyIndex);
+            break;
         }
-    }
 
-    size_t getTaskCount() const {
-        return tasks.size();
-    }
+        case TraceReplaceDependencies: {
+            int taskIndex = trace.getInt();
+            vector<int> dependencyIndices = trace.getIntList();
+            todoList.replaceDependencies(taskIndex, dependencyIndices);
+            break;
+        }
 
-    void changeCategory(const string& category, int count) {
-        categoryCount[category] = count;
-    }
+        case TraceRenameCategory: {
+            int taskIndex = trace.getInt();
+            int categoryIndex = trace.getInt();
+            string newCategory = trace.getString();
+            todoList.renameTaskCategory(taskIndex, categoryIndex, newCategory);
+            break;
+        }
 
-void changeTaskCategory(int taskIndex) {
-    if (checkEmpty()) return;
-    if (taskIndex >= 0 && taskIndex < tasks.size()) {
-        cout << "Current categories for task \"" << tasks[taskIndex].name << "\":" << endl;
-        if (tasks[taskIndex].categories.empty()) {
-            cout << "No categories assigned." << endl;
-            return;
+        case TraceSortedViewPage: {
+            string view = trace.getString();
+            int from = trace.getInt();
+            int count = trace.getInt();
+            vector<int> page;
+            todoList.sortedViewPage(view, from, count, page);
+            break;
         }
-        
-        for (size_t i = 0; i < tasks[taskIndex].categories.size(); i++) {
-            cout << i + 1 << ". " << tasks[taskIndex].categories[i] << endl;
+
+        case TraceSortedViewRank: {
+            string view = trace.getString();
+            int taskIndex = trace.getInt();
+            todoList.sortedViewRank(view, taskIndex);
+            break;
         }
 
-        cout << "Enter the index of category to modify (1-" << tasks[taskIndex].categories.size() << "): ";
-        int categoryIndex;
-        cin >> categoryIndex;
-        categoryIndex--; 
+        case TraceSortedViewSelect: {
+            string view = trace.getString();
+            int rank = trace.getInt();
+            todoList.sortedViewSelect(view, rank);
+            break;
+        }
 
-        if (categoryIndex >= 0 && categoryIndex < tasks[taskIndex].categories.size()) {
-            string oldCategory = tasks[taskIndex].categories[categoryIndex];
-            cout << "Enter new category name: ";
-            cin.ignore();
-            string newCategory;
-            getline(cin, newCategory);
+        default:
+            return false;
+    }
+    return !trace.failed();
+}
 
-            categoryCount[oldCategory]--;
-            categoryCount[newCategory]++;
+// Replays a recorded session headlessly at full speed, then reports
+// throughput, per-call latency and whether the final state hash matches
+// the one captured when the recording finished.
+int replaySession(const string& tracePath) {
+    TraceReader trace;
+    if (!trace.open(tracePath)) {
+        cout << "Could not read session trace \"" << tracePath << "\"." << endl;
+        return 1;
+    }
 
-            tasks[taskIndex].categories[categoryIndex] = newCategory;
-            cout << "Category updated successfully!" << endl;
-        } else {
-            cout << "Invalid category index." << endl;
-        }
-    } else {
-        cout << "Invalid task index." << endl;
+    string archivePath = tracePath + ".replay.archive";
+    remove(archivePath.c_str());
+    ToDoList todoList(archivePath);
+
+    vector<long long> latencies;
+    bool hasExpectedHash = false;
+    unsigned long long expectedHash = 0;
+    bool valid = true;
+
+    auto replayStart = chrono::steady_clock::now();
+    TraceOp op;
+    while (trace.next(op)) {
+        if (op == TraceEnd) {
+            expectedHash = trace.getHash();
+            hasExpectedHash = !trace.failed();
+            break;
+        }
+        auto callStart = chrono::steady_clock::now();
+        if (!replayCall(todoList, op, trace)) {
+            valid = false;
+            break;
+        }
+        latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - callStart).count());
+    }
+    if (trace.failed()) valid = false;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - replayStart).count();
+    remove(archivePath.c_str());
+
+    cout << "Replayed " << latencies.size() << " calls in " << fixed << setprecision(3) << seconds * 1000 << " ms";
+    if (seconds > 0) cout << " (" << setprecision(0) << latencies.size() / seconds << " calls/s)";
+    cout << endl;
+    if (!latencies.empty()) {
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [&latencies](double p) { return latencies[size_t(p * (latencies.size() - 1))] / 1000.0; };
+        cout << setprecision(2) << "Latency (us): p50 " << percentile(0.50) << ", p90 " << percentile(0.90)
+             << ", p99 " << percentile(0.99) << ", max " << latencies.back() / 1000.0 << endl;
+    }
+    cout << defaultfloat;
+
+    if (!valid) {
+        cout << "Trace is corrupt or truncated after call " << latencies.size() << "." << endl;
+        return 1;
     }
+    if (!hasExpectedHash) {
+        cout << "Trace has no final state hash; the recording did not finish cleanly." << endl;
+        return 1;
+    }
+    unsigned long long finalHash = todoList.stateHash();
+    cout << hex << "State hash: " << finalHash << " (recorded " << expectedHash << ")" << dec << endl;
+    if (finalHash != expectedHash) {
+        cout << "❌ Final state differs from the recorded session." << endl;
+        return 1;
+    }
+    cout << "✅ Final state matches the recorded session." << endl;
+    return 0;
 }
-};
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc == 3 && string(argv[1]) == "--replay") {
+        return replaySession(argv[2]);
+    }
+
     ToDoList todoList;
+    if (argc == 3 && string(argv[1]) == "--record") {
+        if (!todoList.startRecording(argv[2])) {
+            cout << "Could not open session trace \"" << argv[2] << "\" for writing." << endl;
+            return 1;
+        }
+    } else if (argc != 1) {
+        cout << "Usage: " << argv[0] << " [--record <trace> | --replay <trace>]" << endl;
+        return 1;
+    }
+
     cout << "\n\n";
     cout << "   ╔══════════════════════════════════════════════════╗" << endl;
     cout << "   ║                 Welcome to ToDoList              ║" << endl;
@@ -521,7 +591,7 @@ int main() {
             if(run_counter>0)
                 cout << "\n📋 Your Todo List is empty.\n";
         }
-        todoList.displayTasks();
+        displayTasks(todoList);
         cout << "\n🎯  Menu Options:\n";
         cout << "1.  ➕ Add New Task\n";
         cout << "2.  ❌ Remove Task\n";
@@ -542,7 +612,12 @@ int main() {
         cout << "17. 📝 Add Task Notes\n";
         cout << "18. ↩️  Undo\n";
         cout << "19. ↪️  Redo\n";
-        cout << "20. 🚪 Exit\n";
+        cout << "20. 🗄️  Archive Completed Tasks\n";
+        cout << "21. 📜 Completed Task History\n";
+        cout << "22. 🔎 Query Tasks\n";
+        cout << "23. 📑 Browse Sorted View\n";
+        cout << "24. 🧠 Memory Report\n";
+        cout << "25. 🚪 Exit\n";
 
         int choice;
         cout << "\n👉 Enter your choice: ";
@@ -560,7 +635,7 @@ int main() {
                 cout << "📝 Enter task name: ";
                 cin.ignore();
                 getline(cin, taskName);
-                todoList.addTask(taskName);
+                int taskIndex = todoList.addTask(taskName);
 
                 cout << "\n✨ Would you like to add more details to this task? (y/n): ";
                 char more;
@@ -572,31 +647,31 @@ int main() {
                     cin.ignore();
                     getline(cin, input);
                     if (!input.empty()) {
-                        todoList.setTaskPriority(todoList.getTaskCount() - 1, stoi(input));
+                        todoList.setTaskPriority(taskIndex, stoi(input));
                     }
 
                     cout << "📅 Enter due date (YYYY-MM-DD, or press Enter to skip): ";
                     getline(cin, input);
                     if (!input.empty()) {
-                        todoList.setTaskDueDate(todoList.getTaskCount() - 1, input);
+                        setTaskDueDate(todoList, taskIndex, input);
                     }
 
                     cout << "🏷️  Enter category (or press Enter to skip): ";
                     getline(cin, input);
                     if (!input.empty()) {
-                        todoList.addTaskCategory(todoList.getTaskCount() - 1, input);
+                        todoList.addTaskCategory(taskIndex, input);
                     }
 
                     cout << "📝 Enter any notes (or press Enter to skip): ";
                     getline(cin, input);
                     if (!input.empty()) {
-                        todoList.addTaskNotes(todoList.getTaskCount() - 1, input);
+                        todoList.addTaskNotes(taskIndex, input);
                     }
 
                     cout << "⏰ Enter reminder date (YYYY-MM-DD, or press Enter to skip): ";
                     getline(cin, input);
                     if (!input.empty()) {
-                        todoList.setReminder(todoList.getTaskCount() - 1, input);
+                        setReminder(todoList, taskIndex, input);
                     }
 
                     cout << "✨ Task details added successfully! ✨\n";
@@ -606,25 +681,25 @@ int main() {
 
 
             case 2: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 cout << "Enter task index to remove: ";
                 cin >> taskIndex;
-                todoList.removeTask(taskIndex - 1);
+                reportStatus(todoList.removeTask(taskIndex - 1));
                 break;
             }
 
             case 3: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 cout << "Enter task index to mark complete: ";
                 cin >> taskIndex;
-                todoList.markComplete(taskIndex - 1);
+                reportStatus(todoList.markComplete(taskIndex - 1));
                 break;
             }
 
             case 4: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex, priority;
                 cout << "Enter task index to set priority: ";
                 cin >> taskIndex;
@@ -635,50 +710,24 @@ int main() {
                         cout << "Invalid priority. Please enter a number between 1 and 5.\n";
                     }
                 } while (priority < 1 || priority > 5);
-                todoList.setTaskPriority(taskIndex - 1, priority);
+                reportStatus(todoList.setTaskPriority(taskIndex - 1, priority));
                 break;
             }
 
             case 5: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 string dueDate;
                 cout << "Enter task index to set due date: ";
                 cin >> taskIndex;
                 cout << "Enter due date (YYYY-MM-DD): ";
                 cin >> dueDate;
-
-                if (dueDate.length() != 10 || dueDate[4] != '-' || dueDate[7] != '-') {
-                    cout << "Invalid date format. Please use YYYY-MM-DD\n";
-                    break;
-                }
-
-                try {
-                    int year = stoi(dueDate.substr(0, 4));
-                    int month = stoi(dueDate.substr(5, 2));
-                    int day = stoi(dueDate.substr(8, 2));
-
-                    if (year < 2024 || month < 1 || month > 12 || day < 1 || day > 31) {
-                        cout << "Invalid date values.\n";
-                        break;
-                    }
-
-                    bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-                    int daysInMonth[] = {31, (isLeapYear ? 29 : 28), 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-                    if (day > daysInMonth[month - 1]) {
-                        cout << "Invalid day for the given month.\n";
-                        break;
-                    }
-
-                    todoList.setTaskDueDate(taskIndex - 1, dueDate);
-                } catch (const exception& e) {
-                    cout << "Invalid date format. Please use YYYY-MM-DD\n";
-                }
+                setTaskDueDate(todoList, taskIndex - 1, dueDate);
                 break;
             }
 
             case 6: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 string category;
                 cout << "Enter task index to add category: ";
@@ -686,69 +735,69 @@ int main() {
                 cout << "Enter category: ";
                 cin.ignore();
                 getline(cin, category);
-                todoList.addTaskCategory(taskIndex - 1, category);
+                reportStatus(todoList.addTaskCategory(taskIndex - 1, category));
                 break;
             }
 
             case 7: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 string reminderDate;
                 cout << "Enter task index for setting reminder: ";
                 cin >> taskIndex;
                 cout << "Enter reminder date: ";
                 cin >> reminderDate;
-                todoList.setReminder(taskIndex - 1, reminderDate);
+                setReminder(todoList, taskIndex - 1, reminderDate);
                 break;
             }
 
             case 8:
-                todoList.displayStatistics();
+                displayStatistics(todoList);
                 break;
 
             case 9:
-                todoList.displayCategoryCount();
+                displayCategoryCount(todoList);
                 break;
 
             case 10: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 cout << "Enter task index to set dependencies: ";
                 cin >> taskIndex;
-                todoList.setTaskDependencies(taskIndex - 1);
+                setTaskDependencies(todoList, taskIndex - 1);
                 break;
             }
 
             case 11: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 cout << "Enter task index to display dependencies: ";
                 cin >> taskIndex;
-                todoList.displayTaskDependencies(taskIndex - 1);
+                displayTaskDependencies(todoList, taskIndex - 1);
                 break;
             }
 
             case 12:
-                todoList.visualizeTaskDependencies();
+                visualizeTaskDependencies(todoList);
                 break;
 
             case 13: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int dependentIndex, dependencyIndex;
                 cout << "Enter dependent task index: ";
                 cin >> dependentIndex;
                 cout << "Enter dependency task index: ";
                 cin >> dependencyIndex;
-                todoList.removeDependency(dependentIndex - 1, dependencyIndex - 1);
+                reportStatus(todoList.removeDependency(dependentIndex - 1, dependencyIndex - 1));
                 break;
             }
 
             case 14: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 cout << "Enter task index to update dependencies: ";
                 cin >> taskIndex;
-                todoList.updateDependencies(taskIndex - 1);
+                updateDependencies(todoList, taskIndex - 1);
                 break;
             }
 
@@ -756,16 +805,16 @@ int main() {
                 string keyword;
                 cout << "Enter keyword to search: ";
                 cin >> keyword;
-                todoList.taskSearch(keyword);
+                taskSearch(todoList, keyword);
                 break;
             }
 
             case 16:
-                todoList.dueDateAlerts();
+                dueDateAlerts(todoList);
                 break;
 
             case 17: {
-                if (todoList.checkEmpty()) break;
+                if (checkEmpty(todoList)) break;
                 int taskIndex;
                 string notes;
                 cout << "Enter task index to add notes: ";
@@ -773,21 +822,58 @@ int main() {
                 cout << "Enter notes: ";
                 cin.ignore();
                 getline(cin, notes);
-                todoList.addTaskNotes(taskIndex - 1, notes);
+                reportStatus(todoList.addTaskNotes(taskIndex - 1, notes));
                 break;
             }
 
             case 18: {
-                todoList.undo();
+                reportStatus(todoList.undo());
                 break;
             }
 
             case 19: {
-                todoList.redo();
+                reportStatus(todoList.redo());
+                break;
+            }
+
+            case 20: {
+                int archivedCount = todoList.archiveCompletedTasks();
+                cout << "🗄️  Archived " << archivedCount << " completed task(s).\n";
                 break;
             }
 
-            case 20:
+            case 21: {
+                string keyword;
+                cout << "Enter keyword to filter history (or press Enter to show all): ";
+                getline(cin, keyword);
+                displayCompletedHistory(todoList, keyword);
+                break;
+            }
+
+            case 22: {
+                string query;
+                cout << "Enter query (e.g. status:open prio>=3 cat:work due<2026-11-01 sort:due,-prio limit:10): ";
+                getline(cin, query);
+                displayQueryResults(todoList, query);
+                break;
+            }
+
+            case 23: {
+                string view;
+                int pageNumber;
+                cout << "Enter view (due, priority, name): ";
+                cin >> view;
+                cout << "Enter page number: ";
+                cin >> pageNumber;
+                displaySortedView(todoList, view, pageNumber);
+                break;
+            }
+
+            case 24:
+                displayMemoryReport();
+                break;
+
+            case 25:
                 cout << "👋 Thank you for using ToDo List! Goodbye!\n";
                 return 0;
             
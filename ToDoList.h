@@ -0,0 +1,842 @@
+#ifndef TODO_TODOLIST_H
+#define TODO_TODOLIST_H
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstddef>
+#include <ctime>
+#include <iterator>
+#include <queue>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "MemoryProfile.h"
+#include "Task.h"
+#include "TaskIndexes.h"
+#include "TaskQuery.h"
+#include "TaskStorage.h"
+
+namespace todo {
+
+// Outcome of a ToDoList call. The engine never prints; front ends turn a
+// status into text with statusMessage().
+enum TodoStatus {
+    StatusOk, StatusEmptyList, StatusInvalidIndex, StatusInvalidDateFormat, StatusInvalidDateValues,
+    StatusInvalidDay, StatusInvalidCategoryIndex, StatusNothingToUndo, StatusNothingToRedo,
+    StatusInvalidQuery, StatusUnknownView, StatusArchiveUnreadable, StatusInvalidPage
+};
+
+inline const char* statusMessage(TodoStatus status) {
+    switch (status) {
+        case StatusOk: return "Done.";
+        case StatusEmptyList: return "No tasks in the list. Please add a task first.";
+        case StatusInvalidIndex: return "Invalid task index. Please provide a valid task index.";
+        case StatusInvalidDateFormat: return "Invalid date format. Please use YYYY-MM-DD format.";
+        case StatusInvalidDateValues: return "Invalid date values.";
+        case StatusInvalidDay: return "Invalid day for the given month.";
+        case StatusInvalidCategoryIndex: return "Invalid category index.";
+        case StatusNothingToUndo: return "Nothing to undo.";
+        case StatusNothingToRedo: return "Nothing to redo.";
+        case StatusInvalidQuery: return "Invalid query.";
+        case StatusUnknownView: return "Unknown view. Use due, priority or name.";
+        case StatusArchiveUnreadable: return "Some archive records are unreadable.";
+        case StatusInvalidPage: return "Invalid page range.";
+    }
+    return "Unknown status.";
+}
+
+struct TaskStatistics {
+    size_t total;
+    size_t completed;
+    size_t archived;
+};
+
+struct ArchivedTask {
+    Task task;
+    std::string archivedOn;
+};
+
+struct UndoEntry {
+    std::string action;
+    int taskIndex;
+    Task task;
+};
+
+// The task engine. Calls report failures through TodoStatus and hand back
+// task indices or references into the task list instead of printing, so the
+// engine can be driven by the console front end, a replay or a benchmark.
+//
+// A task index is a stable slot: removing a task empties its slot instead
+// of shifting later tasks, so dependencies, indexes and undo entries keep
+// pointing at the right task. Empty slots are compacted away when completed
+// tasks are archived.
+class ToDoList {
+private:
+    std::vector<Task> tasks;
+    std::vector<bool> liveSlots;
+    size_t liveCount;
+    std::stack<UndoEntry> undoStack;
+    std::stack<UndoEntry> redoStack;
+    std::priority_queue<std::pair<int, int> > priorityQueue;
+    std::unordered_map<std::string, int> categoryCount;
+    TaskArchive archive;
+    std::unordered_map<std::string, TaskQuery> queryCache;
+    SessionRecorder recorder;
+    std::unordered_map<std::string, TaskBitmap> statusBitmaps;
+    std::unordered_map<std::string, TaskBitmap> categoryBitmaps;
+    OrderStatisticTree<std::pair<bool, std::string> > dueView;
+    OrderStatisticTree<long long> priorityView;
+    OrderStatisticTree<std::string> nameView;
+
+    static std::pair<bool, std::string> dueKey(const Task& task) { return std::make_pair(task.dueDate.empty(), task.dueDate); }
+    // Negated in 64 bits so INT_MIN still has a key.
+    static long long priorityKey(const Task& task) { return -(long long)task.priority; }
+    static std::string nameKey(const Task& task) { return task.name; }
+
+    // Shared guard for calls that take a task index.
+    TodoStatus checkIndex(int taskIndex) const {
+        if (liveCount == 0) return StatusEmptyList;
+        return hasTask(taskIndex) ? StatusOk : StatusInvalidIndex;
+    }
+
+    // Runs action(tree, keyOf) on the named sorted view. Views are "due"
+    // (earliest first, undated last), "priority" (highest first) and "name".
+    template <typename Action>
+    bool withSortedView(const std::string& view, Action action) {
+        if (view == "due") action(dueView, dueKey);
+        else if (view == "priority") action(priorityView, priorityKey);
+        else if (view == "name") action(nameView, nameKey);
+        else return false;
+        return true;
+    }
+
+    // Parsed queries are cached by their text so repeated queries skip parsing.
+    const TaskQuery& compileQuery(const std::string& text) {
+        auto cached = queryCache.find(text);
+        if (cached != queryCache.end()) return cached->second;
+        if (queryCache.size() >= 256) queryCache.clear();
+        return queryCache.emplace(text, TaskQuery::parse(text)).first->second;
+    }
+
+    TaskQuery::Strategy planQuery(const TaskQuery& query) {
+        if (query.minPriority > query.maxPriority || (query.requireDueDate && query.requireNoDueDate)) {
+            return TaskQuery::EmptyResult;
+        }
+        if (query.status != TaskQuery::AnyStatus || !query.categoryGroups.empty()) {
+            return TaskQuery::BitmapScan;
+        }
+        if (query.limit > 0 && !query.sortedViewName().empty()) {
+            return TaskQuery::SortedViewScan;
+        }
+        return TaskQuery::FullScan;
+    }
+
+    // Intersects the status and category bitmaps for a query with at least
+    // one status or category term.
+    TaskBitmap candidateTasks(const TaskQuery& query) {
+        TaskBitmap candidates;
+        bool first = true;
+        if (query.status != TaskQuery::AnyStatus) {
+            candidates = statusBitmaps[query.status == TaskQuery::CompleteOnly ? "Complete" : "Incomplete"];
+            first = false;
+        }
+        for (const std::vector<std::string>& group : query.categoryGroups) {
+            TaskBitmap anyOf;
+            for (const std::string& category : group) {
+                auto entry = categoryBitmaps.find(category);
+                if (entry != categoryBitmaps.end()) anyOf = anyOf | entry->second;
+            }
+            candidates = first ? anyOf : candidates & anyOf;
+            first = false;
+            if (candidates.empty()) return candidates;
+        }
+        for (const std::string& category : query.excludedCategories) {
+            auto entry = categoryBitmaps.find(category);
+            if (entry != categoryBitmaps.end()) candidates = candidates.andNot(entry->second);
+        }
+        return candidates;
+    }
+
+    // Visits matching task indices in list order until visit returns false.
+    template <typename Visitor>
+    void scanQuery(const TaskQuery& query, Visitor visit) {
+        TaskQuery::Strategy strategy = planQuery(query);
+        if (strategy == TaskQuery::EmptyResult) return;
+        if (strategy == TaskQuery::BitmapScan) {
+            candidateTasks(query).forEach([&](int taskIndex) {
+                return !query.matchesFields(tasks[taskIndex]) || visit(taskIndex);
+            });
+            return;
+        }
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (liveSlots[i] && query.matches(tasks[i]) && !visit(i)) return;
+        }
+    }
+
+    // Pops a bounded "best so far" heap into result order.
+    template <typename Heap>
+    static std::vector<int> drainBest(Heap& best) {
+        std::vector<int> results(best.size());
+        for (size_t i = results.size(); i > 0; --i) {
+            results[i - 1] = best.top();
+            best.pop();
+        }
+        return results;
+    }
+
+    // Walks the view matching the primary sort key up to the first `limit`
+    // matches. Views break ties by task index, as TaskQuery::before() does,
+    // so with a single sort key those are the answer. With secondary keys,
+    // fewer than `limit` matches are simply sorted; otherwise only tasks
+    // tied with the last of them on the primary key can still displace one,
+    // and they go through a bounded heap. A short tie is read off the view,
+    // while a long one is cheaper to find with a sequential pass over the
+    // slots than by chasing the view's key order across memory.
+    std::vector<int> topFromSortedView(const TaskQuery& query) {
+        std::vector<int> results;
+        auto comesBefore = [&](int a, int b) { return query.before(tasks[a], a, tasks[b], b); };
+        std::priority_queue<int, std::vector<int>, decltype(comesBefore)> best(comesBefore);
+        auto offer = [&](int taskIndex) {
+            if (!query.matches(tasks[taskIndex]) || !comesBefore(taskIndex, best.top())) return;
+            best.pop();
+            best.push(taskIndex);
+        };
+        const int batch = 256;
+        withSortedView(query.sortedViewName(), [&](const auto& view, auto keyOf) {
+            int walked = 0;
+            while (walked < view.size() && results.size() < query.limit) {
+                for (int taskIndex : view.page(walked, batch)) {
+                    walked++;
+                    if (query.matches(tasks[taskIndex])) results.push_back(taskIndex);
+                    if (results.size() == query.limit) break;
+                }
+            }
+            if (query.sortKeys.size() == 1) return;
+            if (results.size() < query.limit) {
+                // The whole view was walked, so every match is already here.
+                std::sort(results.begin(), results.end(), comesBefore);
+                return;
+            }
+
+            for (int taskIndex : results) best.push(taskIndex);
+            int boundary = results.back();
+            int tiedEnd = view.rank(keyOf(tasks[boundary]), INT_MAX);
+            if ((size_t)(tiedEnd - walked) * 4 < tasks.size() - boundary) {
+                for (; walked < tiedEnd; walked += batch) {
+                    for (int taskIndex : view.page(walked, std::min(batch, tiedEnd - walked))) offer(taskIndex);
+                }
+            } else {
+                // Within one key the view is in slot order, so the tied tasks
+                // not yet seen all sit after the boundary slot.
+                for (size_t i = boundary + 1; i < tasks.size(); ++i) {
+                    if (liveSlots[i] && query.compareOn(0, tasks[i], tasks[boundary]) == 0) offer(i);
+                }
+            }
+            results = drainBest(best);
+        });
+        return results;
+    }
+
+    void indexTask(int taskIndex) {
+        MemoryScope scope(MemIndexes);
+        const Task& task = tasks[taskIndex];
+        statusBitmaps[task.status].add(taskIndex);
+        for (const std::string& category : task.categories) {
+            categoryBitmaps[category].add(taskIndex);
+        }
+        dueView.insert(dueKey(task), taskIndex);
+        priorityView.insert(priorityKey(task), taskIndex);
+        nameView.insert(nameKey(task), taskIndex);
+    }
+
+    void unindexTask(int taskIndex) {
+        MemoryScope scope(MemIndexes);
+        const Task& task = tasks[taskIndex];
+        statusBitmaps[task.status].remove(taskIndex);
+        for (const std::string& category : task.categories) {
+            categoryBitmaps[category].remove(taskIndex);
+        }
+        dueView.erase(dueKey(task), taskIndex);
+        priorityView.erase(priorityKey(task), taskIndex);
+        nameView.erase(nameKey(task), taskIndex);
+    }
+
+    // Only needed after archiving compacts the slots; every other change
+    // updates the bitmaps and sorted views for the slots it touches.
+    void rebuildIndexes() {
+        MemoryScope scope(MemIndexes);
+        statusBitmaps.clear();
+        categoryBitmaps.clear();
+        dueView.clear();
+        priorityView.clear();
+        nameView.clear();
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (liveSlots[i]) indexTask(i);
+        }
+    }
+
+    void recordUndo(const std::string& action, int taskIndex, const Task& task) {
+        MemoryScope scope(MemUndo);
+        undoStack.push(UndoEntry{action, taskIndex, task});
+        redoStack = std::stack<UndoEntry>();
+    }
+
+    void pushPriority(int priority, int taskIndex) {
+        MemoryScope scope(MemPriorityQueue);
+        priorityQueue.push(std::make_pair(priority, taskIndex));
+    }
+
+    void updateCategoryCount(const Task& task, bool decrement = false) {
+        MemoryScope scope(MemIndexes);
+        for (const std::string& category : task.categories) {
+            if (decrement) {
+                categoryCount[category]--;
+            } else {
+                categoryCount[category]++;
+            }
+        }
+    }
+
+    // Puts a task back into its slot (undo of a remove, redo of an add).
+    void restoreSlot(int taskIndex, const Task& task) {
+        {
+            MemoryScope scope(MemTasks);
+            tasks[taskIndex] = task;
+        }
+        liveSlots[taskIndex] = true;
+        liveCount++;
+        pushPriority(task.priority, taskIndex);
+        updateCategoryCount(task);
+        indexTask(taskIndex);
+    }
+
+    // Empties a slot. The index is not reused, so the slot can be restored.
+    void releaseSlot(int taskIndex) {
+        unindexTask(taskIndex);
+        updateCategoryCount(tasks[taskIndex], true);
+        tasks[taskIndex] = Task("");
+        liveSlots[taskIndex] = false;
+        liveCount--;
+    }
+
+    TodoStatus linkDependency(int dependentIndex, int dependencyIndex) {
+        if (!hasTask(dependentIndex) || !hasTask(dependencyIndex)) return StatusInvalidIndex;
+        tasks[dependentIndex].dependencies.insert(dependencyIndex);
+        return StatusOk;
+    }
+
+public:
+    // Iterates the live tasks in slot order; index() gives the task index.
+    class const_iterator {
+    private:
+        const ToDoList* list;
+        int slot;
+
+        void skipEmptySlots() {
+            while (slot < (int)list->tasks.size() && !list->liveSlots[slot]) slot++;
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Task value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Task* pointer;
+        typedef const Task& reference;
+
+        const_iterator(const ToDoList* owner, int start) : list(owner), slot(start) { skipEmptySlots(); }
+
+        int index() const { return slot; }
+        reference operator*() const { return list->tasks[slot]; }
+        pointer operator->() const { return &list->tasks[slot]; }
+
+        const_iterator& operator++() {
+            slot++;
+            skipEmptySlots();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return slot == other.slot; }
+        bool operator!=(const const_iterator& other) const { return slot != other.slot; }
+    };
+
+    ToDoList(const std::string& archivePath = "completed_tasks.archive") : liveCount(0), archive(archivePath) {}
+
+    ~ToDoList() {
+        finishRecording();
+    }
+
+    bool startRecording(const std::string& tracePath) {
+        MemoryOperation operation("startRecording", MemTrace);
+        return recorder.start(tracePath);
+    }
+
+    void finishRecording() {
+        MemoryOperation operation("finishRecording", MemTrace);
+        recorder.finish(stateHash());
+    }
+
+    // FNV-1a hash over every task field, used to check that a replayed
+    // session ends in the same state as the recorded one.
+    unsigned long long stateHash() const {
+        MemoryOperation operation("stateHash", MemOther);
+        unsigned long long hash = 14695981039346656037ull;
+        auto mix = [&hash](const std::string& value) {
+            for (unsigned char c : value) {
+                hash = (hash ^ c) * 1099511628211ull;
+            }
+            hash = (hash ^ 0xFF) * 1099511628211ull;
+        };
+        for (const_iterator it = begin(); it != end(); ++it) {
+            const Task& task = *it;
+            mix(std::to_string(it.index()));
+            mix(task.name);
+            mix(task.status);
+            mix(std::to_string(task.priority));
+            mix(task.dueDate);
+            mix(task.reminderDate);
+            mix(task.notes);
+            for (const std::string& category : task.categories) {
+                mix(category);
+            }
+            std::vector<int> dependencies(task.dependencies.begin(), task.dependencies.end());
+            std::sort(dependencies.begin(), dependencies.end());
+            for (int dependencyIndex : dependencies) {
+                mix(std::to_string(dependencyIndex));
+            }
+            mix("");
+        }
+        return hash;
+    }
+
+    // Checks a YYYY-MM-DD date from 2024 onwards, including month lengths
+    // and leap years.
+    static TodoStatus validateDate(const std::string& date) {
+        MemoryOperation operation("validateDate", MemOther);
+        if (date.length() != 10 || date[4] != '-' || date[7] != '-') return StatusInvalidDateFormat;
+        for (size_t i = 0; i < date.length(); ++i) {
+            if (i != 4 && i != 7 && !isdigit((unsigned char)date[i])) return StatusInvalidDateFormat;
+        }
+
+        int year = std::stoi(date.substr(0, 4));
+        int month = std::stoi(date.substr(5, 2));
+        int day = std::stoi(date.substr(8, 2));
+        if (year < 2024 || month < 1 || month > 12 || day < 1 || day > 31) return StatusInvalidDateValues;
+
+        bool isLeapYear = (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+        int daysInMonth[] = {31, (isLeapYear ? 29 : 28), 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        if (day > daysInMonth[month - 1]) return StatusInvalidDay;
+        return StatusOk;
+    }
+
+    bool empty() const { return liveCount == 0; }
+
+    size_t getTaskCount() const {
+        return liveCount;
+    }
+
+    bool hasTask(int taskIndex) const {
+        return taskIndex >= 0 && taskIndex < (int)tasks.size() && liveSlots[taskIndex];
+    }
+
+    const Task& getTask(int taskIndex) const { return tasks[taskIndex]; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, tasks.size()); }
+
+    const std::unordered_map<std::string, int>& getCategoryCounts() const { return categoryCount; }
+
+    TodoStatus addDependency(int dependentIndex, int dependencyIndex) {
+        recorder.record(TraceAddDependency, dependentIndex, dependencyIndex);
+        MemoryOperation operation("addDependency", MemDependencies);
+        return linkDependency(dependentIndex, dependencyIndex);
+    }
+
+    // Replaces a task's dependencies with the given task indices. Invalid
+    // indices are skipped and reported once the valid ones are linked.
+    TodoStatus replaceDependencies(int taskIndex, const std::vector<int>& dependencyIndices) {
+        recorder.record(TraceReplaceDependencies, taskIndex, dependencyIndices);
+        MemoryOperation operation("replaceDependencies", MemDependencies);
+        if (!hasTask(taskIndex)) return StatusInvalidIndex;
+        tasks[taskIndex].dependencies.clear();
+        TodoStatus status = StatusOk;
+        for (int dependencyIndex : dependencyIndices) {
+            if (linkDependency(taskIndex, dependencyIndex) != StatusOk) status = StatusInvalidIndex;
+        }
+        return status;
+    }
+
+    TodoStatus removeDependency(int dependentIndex, int dependencyIndex) {
+        recorder.record(TraceRemoveDependency, dependentIndex, dependencyIndex);
+        MemoryOperation operation("removeDependency", MemDependencies);
+        if (liveCount == 0) return StatusEmptyList;
+        if (!hasTask(dependentIndex) || !hasTask(dependencyIndex)) return StatusInvalidIndex;
+        tasks[dependentIndex].dependencies.erase(dependencyIndex);
+        return StatusOk;
+    }
+
+    // Returns the new task's index.
+    int addTask(const std::string& taskName) {
+        recorder.record(TraceAddTask, taskName);
+        MemoryOperation operation("addTask");
+        int taskIndex = tasks.size();
+        Task newTask(taskName);
+        tasks.push_back(newTask);
+        liveSlots.push_back(true);
+        liveCount++;
+        recordUndo("add", taskIndex, newTask);
+        pushPriority(0, taskIndex);
+        updateCategoryCount(newTask);
+        indexTask(taskIndex);
+        return taskIndex;
+    }
+
+    TodoStatus removeTask(int taskIndex) {
+        recorder.record(TraceRemoveTask, taskIndex);
+        MemoryOperation operation("removeTask");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+
+        recordUndo("remove", taskIndex, tasks[taskIndex]);
+        releaseSlot(taskIndex);
+        return StatusOk;
+    }
+
+    TodoStatus markComplete(int taskIndex) {
+        recorder.record(TraceMarkComplete, taskIndex);
+        MemoryOperation operation("markComplete");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+
+        std::string oldStatus = tasks[taskIndex].status;
+        tasks[taskIndex].status = "Complete";
+        recordUndo("mark_incomplete", taskIndex, tasks[taskIndex]);
+
+        MemoryScope scope(MemIndexes);
+        statusBitmaps[oldStatus].remove(taskIndex);
+        statusBitmaps["Complete"].add(taskIndex);
+        return StatusOk;
+    }
+
+    TodoStatus setTaskPriority(int taskIndex, int priority) {
+        recorder.record(TraceSetPriority, taskIndex, priority);
+        MemoryOperation operation("setTaskPriority");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+
+        int oldPriority = tasks[taskIndex].priority;
+        tasks[taskIndex].priority = priority;
+        if (oldPriority != priority) {
+            pushPriority(priority, taskIndex);
+            MemoryScope scope(MemIndexes);
+            priorityView.erase(-(long long)oldPriority, taskIndex);
+            priorityView.insert(-(long long)priority, taskIndex);
+        }
+        return StatusOk;
+    }
+
+    TodoStatus setTaskDueDate(int taskIndex, const std::string& dueDate) {
+        recorder.record(TraceSetDueDate, taskIndex, dueDate);
+        MemoryOperation operation("setTaskDueDate");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status == StatusOk) status = validateDate(dueDate);
+        if (status != StatusOk) return status;
+
+        dueView.erase(dueKey(tasks[taskIndex]), taskIndex);
+        tasks[taskIndex].dueDate = dueDate;
+        MemoryScope scope(MemIndexes);
+        dueView.insert(dueKey(tasks[taskIndex]), taskIndex);
+        return StatusOk;
+    }
+
+    TodoStatus addTaskCategory(int taskIndex, const std::string& category) {
+        recorder.record(TraceAddCategory, taskIndex, category);
+        MemoryOperation operation("addTaskCategory");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+
+        tasks[taskIndex].categories.push_back(category);
+        MemoryScope scope(MemIndexes);
+        categoryCount[category]++;
+        categoryBitmaps[category].add(taskIndex);
+        return StatusOk;
+    }
+
+    TodoStatus renameTaskCategory(int taskIndex, int categoryIndex, const std::string& newCategory) {
+        recorder.record(TraceRenameCategory, taskIndex, categoryIndex, newCategory);
+        MemoryOperation operation("renameTaskCategory");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+        if (categoryIndex < 0 || categoryIndex >= (int)tasks[taskIndex].categories.size()) return StatusInvalidCategoryIndex;
+
+        std::string oldCategory = tasks[taskIndex].categories[categoryIndex];
+        tasks[taskIndex].categories[categoryIndex] = newCategory;
+
+        MemoryScope scope(MemIndexes);
+        categoryCount[oldCategory]--;
+        categoryCount[newCategory]++;
+        const std::vector<std::string>& categories = tasks[taskIndex].categories;
+        if (std::find(categories.begin(), categories.end(), oldCategory) == categories.end()) {
+            categoryBitmaps[oldCategory].remove(taskIndex);
+        }
+        categoryBitmaps[newCategory].add(taskIndex);
+        return StatusOk;
+    }
+
+    TodoStatus setReminder(int taskIndex, const std::string& reminderDate) {
+        recorder.record(TraceSetReminder, taskIndex, reminderDate);
+        MemoryOperation operation("setReminder");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status == StatusOk) status = validateDate(reminderDate);
+        if (status != StatusOk) return status;
+
+        tasks[taskIndex].reminderDate = reminderDate;
+        return StatusOk;
+    }
+
+    TodoStatus addTaskNotes(int taskIndex, const std::string& notes) {
+        recorder.record(TraceAddNotes, taskIndex, notes);
+        MemoryOperation operation("addTaskNotes");
+        TodoStatus status = checkIndex(taskIndex);
+        if (status != StatusOk) return status;
+
+        tasks[taskIndex].notes += notes;
+        return StatusOk;
+    }
+
+    TodoStatus undo() {
+        recorder.record(TraceUndo);
+        MemoryOperation operation("undo", MemUndo);
+        if (undoStack.empty()) return StatusNothingToUndo;
+
+        UndoEntry entry = undoStack.top();
+        undoStack.pop();
+
+        if (entry.action == "add") {
+            releaseSlot(entry.taskIndex);
+            priorityQueue.pop();
+        } else if (entry.action == "remove") {
+            restoreSlot(entry.taskIndex, entry.task);
+        } else if (entry.action == "mark_incomplete") {
+            entry.task.status = "Incomplete";
+        }
+
+        redoStack.push(entry);
+        return StatusOk;
+    }
+
+    TodoStatus redo() {
+        recorder.record(TraceRedo);
+        MemoryOperation operation("redo", MemUndo);
+        if (redoStack.empty()) return StatusNothingToRedo;
+
+        UndoEntry entry = redoStack.top();
+        redoStack.pop();
+
+        if (entry.action == "add") {
+            restoreSlot(entry.taskIndex, entry.task);
+        } else if (entry.action == "remove") {
+            releaseSlot(entry.taskIndex);
+            priorityQueue.pop();
+        } else if (entry.action == "mark_incomplete") {
+            entry.task.status = "Complete";
+        }
+
+        undoStack.push(entry);
+        return StatusOk;
+    }
+
+    // Indices of tasks whose name or notes contain the keyword, in list order.
+    std::vector<int> searchTasks(const std::string& keyword) {
+        recorder.record(TraceSearchTasks, keyword);
+        MemoryOperation operation("searchTasks", MemQueries);
+        std::vector<int> results;
+        for (const_iterator it = begin(); it != end(); ++it) {
+            if (it->name.find(keyword) != std::string::npos || it->notes.find(keyword) != std::string::npos) {
+                results.push_back(it.index());
+            }
+        }
+        return results;
+    }
+
+    // Indices of tasks with a due date, earliest first, read off the due view.
+    std::vector<int> tasksByDueDate() {
+        recorder.record(TraceTasksByDueDate);
+        MemoryOperation operation("tasksByDueDate", MemQueries);
+        std::vector<int> results = dueView.page(0, dueView.size());
+        while (!results.empty() && tasks[results.back()].dueDate.empty()) results.pop_back();
+        return results;
+    }
+
+    // Fills results with the indices of matching tasks in query order. With
+    // a limit, only the best `limit` matches are kept in a bounded heap
+    // instead of sorting every match. A query that fails to parse returns
+    // StatusInvalidQuery with the parser's message in error.
+    TodoStatus runQuery(const std::string& text, std::vector<int>& results, std::string& error) {
+        recorder.record(TraceRunQuery, text);
+        MemoryOperation operation("runQuery", MemQueries);
+        const TaskQuery& query = compileQuery(text);
+        results.clear();
+        error = query.error;
+        if (!error.empty()) return StatusInvalidQuery;
+        if (planQuery(query) == TaskQuery::SortedViewScan) {
+            results = topFromSortedView(query);
+            return StatusOk;
+        }
+
+        auto comesBefore = [&](int a, int b) { return query.before(tasks[a], a, tasks[b], b); };
+        if (query.limit == 0 || query.sortKeys.empty()) {
+            scanQuery(query, [&](int taskIndex) {
+                results.push_back(taskIndex);
+                return !query.sortKeys.empty() || results.size() != query.limit;
+            });
+            if (!query.sortKeys.empty()) std::sort(results.begin(), results.end(), comesBefore);
+            return StatusOk;
+        }
+
+        std::priority_queue<int, std::vector<int>, decltype(comesBefore)> best(comesBefore);
+        scanQuery(query, [&](int taskIndex) {
+            if (best.size() < query.limit) {
+                best.push(taskIndex);
+            } else if (comesBefore(taskIndex, best.top())) {
+                best.pop();
+                best.push(taskIndex);
+            }
+            return true;
+        });
+        results = drainBest(best);
+        return StatusOk;
+    }
+
+    // Rank of a task within a sorted view, or -1 for an unknown view or index.
+    int sortedViewRank(const std::string& view, int taskIndex) {
+        recorder.record(TraceSortedViewRank, view, taskIndex);
+        MemoryOperation operation("sortedViewRank", MemIndexes);
+        if (!hasTask(taskIndex)) return -1;
+        int result = -1;
+        withSortedView(view, [&](const auto& tree, auto keyOf) { result = tree.rank(keyOf(tasks[taskIndex]), taskIndex); });
+        return result;
+    }
+
+    // Task index at a rank within a sorted view, or -1 if out of range.
+    int sortedViewSelect(const std::string& view, int rank) {
+        recorder.record(TraceSortedViewSelect, view, rank);
+        MemoryOperation operation("sortedViewSelect", MemIndexes);
+        int result = -1;
+        withSortedView(view, [&](const auto& tree, auto) { result = tree.select(rank); });
+        return result;
+    }
+
+    // Fills page with up to `count` task indices starting at rank `from`.
+    TodoStatus sortedViewPage(const std::string& view, int from, int count, std::vector<int>& page) {
+        recorder.record(TraceSortedViewPage, view, from, count);
+        MemoryOperation operation("sortedViewPage", MemIndexes);
+        page.clear();
+        if (from < 0 || count < 0) return StatusInvalidPage;
+        if (!withSortedView(view, [&](const auto& tree, auto) { page = tree.page(from, count); })) return StatusUnknownView;
+        return StatusOk;
+    }
+
+    TaskStatistics statistics() {
+        recorder.record(TraceStatistics);
+        MemoryOperation operation("statistics", MemQueries);
+        TaskStatistics stats = {liveCount, 0, archive.size()};
+        for (const Task& task : *this) {
+            if (task.status == "Complete") {
+                stats.completed++;
+            }
+        }
+        stats.total += stats.archived;
+        stats.completed += stats.archived;
+        return stats;
+    }
+
+    // Moves completed tasks out of the working set into the cold archive and
+    // compacts the slots, dropping empty ones. Dependency indices are
+    // remapped to the surviving tasks, and undo/redo history is cleared
+    // since it refers to the old slots.
+    int archiveCompletedTasks() {
+        recorder.record(TraceArchiveCompleted);
+        MemoryOperation operation("archiveCompletedTasks", MemArchive);
+        time_t now = time(nullptr);
+        char today[11];
+        strftime(today, sizeof(today), "%Y-%m-%d", localtime(&now));
+
+        int archivedCount = 0;
+        for (const Task& task : *this) {
+            if (task.status == "Complete") {
+                archive.stage(task, today);
+                archivedCount++;
+            }
+        }
+        if (archivedCount == 0 || !archive.commit()) return 0;
+
+        std::vector<int> newIndex(tasks.size(), -1);
+        std::vector<Task> activeTasks;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (!liveSlots[i]) continue;
+            if (tasks[i].status == "Complete") {
+                updateCategoryCount(tasks[i], true);
+            } else {
+                MemoryScope scope(MemTasks);
+                newIndex[i] = activeTasks.size();
+                activeTasks.push_back(tasks[i]);
+            }
+        }
+
+        MemoryScope scope(MemDependencies);
+        for (Task& task : activeTasks) {
+            std::unordered_set<int> remapped;
+            for (int dependencyIndex : task.dependencies) {
+                if (newIndex[dependencyIndex] != -1) {
+                    remapped.insert(newIndex[dependencyIndex]);
+                }
+            }
+            task.dependencies = remapped;
+        }
+        {
+            MemoryScope scope(MemTasks);
+            tasks = std::move(activeTasks);
+        }
+        liveSlots.assign(tasks.size(), true);
+        liveCount = tasks.size();
+        rebuildIndexes();
+
+        priorityQueue = std::priority_queue<std::pair<int, int> >();
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            pushPriority(tasks[i].priority, i);
+        }
+        undoStack = std::stack<UndoEntry>();
+        redoStack = std::stack<UndoEntry>();
+        return archivedCount;
+    }
+
+    // Reads archived tasks whose name or notes contain the keyword (all of
+    // them for an empty keyword) in one sequential pass over the segment.
+    // Unreadable records, including a torn final one, are skipped and
+    // reported through StatusArchiveUnreadable.
+    TodoStatus completedHistory(const std::string& keyword, std::vector<ArchivedTask>& history) {
+        recorder.record(TraceCompletedHistory, keyword);
+        MemoryOperation operation("completedHistory", MemArchive);
+        history.clear();
+        bool readable = archive.forEach([&](const Task& task, const std::string& archivedOn) {
+            if (keyword.empty() || task.name.find(keyword) != std::string::npos || task.notes.find(keyword) != std::string::npos) {
+                history.push_back(ArchivedTask{task, archivedOn});
+            }
+        });
+        return readable ? StatusOk : StatusArchiveUnreadable;
+    }
+};
+
+}  // namespace todo
+
+#endif